@@ -80,6 +80,9 @@ static BackendInfo BackendList[] = {
 
     { NULL, NULL, NULL, NULL, EmptyFuncs }
 };
+static BackendInfo BackendLoopback = {
+    "loopback", alc_loopback_init, alc_loopback_deinit, alc_loopback_probe, EmptyFuncs
+};
 #undef EmptyFuncs
 
 ///////////////////////////////////////////////////////
@@ -127,6 +130,10 @@ static const ALCfunction alcFunctions[] = {
     { "alcSetThreadContext",        (ALCvoid *) alcSetThreadContext      },
     { "alcGetThreadContext",        (ALCvoid *) alcGetThreadContext      },
 
+    { "alcLoopbackOpenDeviceSOFT",  (ALCvoid *) alcLoopbackOpenDeviceSOFT },
+    { "alcIsRenderFormatSupportedSOFT", (ALCvoid *) alcIsRenderFormatSupportedSOFT },
+    { "alcRenderSamplesSOFT",       (ALCvoid *) alcRenderSamplesSOFT     },
+
     { "alEnable",                   (ALCvoid *) alEnable                 },
     { "alDisable",                  (ALCvoid *) alDisable                },
     { "alIsEnabled",                (ALCvoid *) alIsEnabled              },
@@ -238,10 +245,16 @@ static const ALCfunction alcFunctions[] = {
     { "alGetAuxiliaryEffectSlotfv", (ALCvoid *) alGetAuxiliaryEffectSlotfv},
 
     { "alBufferSubDataSOFT",        (ALCvoid *) alBufferSubDataSOFT      },
-#if 0
+    { "alBufferDataStatic",         (ALCvoid *) alBufferDataStatic       },
+    /* AL_EXT_sample_buffer_object isn't finished, so only what
+     * AL_SOFTX_databuffer_file needs to create and use a databuffer is
+     * exposed */
     { "alGenDatabuffersEXT",        (ALCvoid *) alGenDatabuffersEXT      },
     { "alDeleteDatabuffersEXT",     (ALCvoid *) alDeleteDatabuffersEXT   },
     { "alIsDatabufferEXT",          (ALCvoid *) alIsDatabufferEXT        },
+    { "alSelectDatabufferEXT",      (ALCvoid *) alSelectDatabufferEXT    },
+    { "alDatabufferFileSOFT",       (ALCvoid *) alDatabufferFileSOFT     },
+#if 0
     { "alDatabufferDataEXT",        (ALCvoid *) alDatabufferDataEXT      },
     { "alDatabufferSubDataEXT",     (ALCvoid *) alDatabufferSubDataEXT   },
     { "alGetDatabufferSubDataEXT",  (ALCvoid *) alGetDatabufferSubDataEXT},
@@ -253,10 +266,11 @@ static const ALCfunction alcFunctions[] = {
     { "alGetDatabufferfvEXT",       (ALCvoid *) alGetDatabufferfvEXT     },
     { "alGetDatabufferiEXT",        (ALCvoid *) alGetDatabufferiEXT      },
     { "alGetDatabufferivEXT",       (ALCvoid *) alGetDatabufferivEXT     },
-    { "alSelectDatabufferEXT",      (ALCvoid *) alSelectDatabufferEXT    },
     { "alMapDatabufferEXT",         (ALCvoid *) alMapDatabufferEXT       },
     { "alUnmapDatabufferEXT",       (ALCvoid *) alUnmapDatabufferEXT     },
 #endif
+    { "alBufferDataAsyncSOFT",      (ALCvoid *) alBufferDataAsyncSOFT    },
+    { "alWaitBufferSOFT",           (ALCvoid *) alWaitBufferSOFT         },
     { NULL,                         (ALCvoid *) NULL                     }
 };
 
@@ -291,6 +305,35 @@ static const ALCenums enumeration[] = {
     { "ALC_EFX_MINOR_VERSION",                ALC_EFX_MINOR_VERSION               },
     { "ALC_MAX_AUXILIARY_SENDS",              ALC_MAX_AUXILIARY_SENDS             },
 
+    // Extension Properties
+    { "ALC_BUFFER_BYTES_SAVED_SOFT",          ALC_BUFFER_BYTES_SAVED_SOFT         },
+    { "ALC_EFFECT_SLOT_UPDATES_SKIPPED_SOFT", ALC_EFFECT_SLOT_UPDATES_SKIPPED_SOFT },
+    { "ALC_EFFECT_MEMORY_SOFT", ALC_EFFECT_MEMORY_SOFT },
+    { "ALC_DEVICE_STATS_SIZE_SOFT",           ALC_DEVICE_STATS_SIZE_SOFT          },
+    { "ALC_DEVICE_STATS_SOFT",                ALC_DEVICE_STATS_SOFT               },
+    { "ALC_UNDERRUNS_SOFT",                   ALC_UNDERRUNS_SOFT                  },
+    { "ALC_MIX_TIME_MIN_SOFT",                ALC_MIX_TIME_MIN_SOFT               },
+    { "ALC_MIX_TIME_AVG_SOFT",                ALC_MIX_TIME_AVG_SOFT               },
+    { "ALC_MIX_TIME_MAX_SOFT",                ALC_MIX_TIME_MAX_SOFT               },
+    { "ALC_BUFFERED_SAMPLES_SOFT",            ALC_BUFFERED_SAMPLES_SOFT           },
+    { "ALC_CALLBACK_JITTER_SOFT",             ALC_CALLBACK_JITTER_SOFT            },
+    { "ALC_OUTPUT_LATENCY_SOFT",              ALC_OUTPUT_LATENCY_SOFT             },
+    { "ALC_FORMAT_CHANNELS_SOFT",             ALC_FORMAT_CHANNELS_SOFT            },
+    { "ALC_FORMAT_TYPE_SOFT",                 ALC_FORMAT_TYPE_SOFT                },
+    { "ALC_BYTE_SOFT",                        ALC_BYTE_SOFT                       },
+    { "ALC_UNSIGNED_BYTE_SOFT",               ALC_UNSIGNED_BYTE_SOFT              },
+    { "ALC_SHORT_SOFT",                       ALC_SHORT_SOFT                      },
+    { "ALC_UNSIGNED_SHORT_SOFT",              ALC_UNSIGNED_SHORT_SOFT             },
+    { "ALC_INT_SOFT",                         ALC_INT_SOFT                        },
+    { "ALC_UNSIGNED_INT_SOFT",                ALC_UNSIGNED_INT_SOFT               },
+    { "ALC_FLOAT_SOFT",                       ALC_FLOAT_SOFT                      },
+    { "ALC_MONO_SOFT",                        ALC_MONO_SOFT                       },
+    { "ALC_STEREO_SOFT",                      ALC_STEREO_SOFT                     },
+    { "ALC_QUAD_SOFT",                        ALC_QUAD_SOFT                       },
+    { "ALC_5POINT1_SOFT",                     ALC_5POINT1_SOFT                    },
+    { "ALC_6POINT1_SOFT",                     ALC_6POINT1_SOFT                    },
+    { "ALC_7POINT1_SOFT",                     ALC_7POINT1_SOFT                    },
+
     // ALC Error Message
     { "ALC_NO_ERROR",                         ALC_NO_ERROR                        },
     { "ALC_INVALID_DEVICE",                   ALC_INVALID_DEVICE                  },
@@ -324,10 +367,12 @@ static ALCchar *alcCaptureDefaultDeviceSpecifier;
 
 static const ALCchar alcNoDeviceExtList[] =
     "ALC_ENUMERATE_ALL_EXT ALC_ENUMERATION_EXT ALC_EXT_CAPTURE "
-    "ALC_EXT_thread_local_context";
+    "ALC_EXT_thread_local_context ALC_SOFT_loopback";
 static const ALCchar alcExtensionList[] =
     "ALC_ENUMERATE_ALL_EXT ALC_ENUMERATION_EXT ALC_EXT_CAPTURE "
-    "ALC_EXT_disconnect ALC_EXT_EFX ALC_EXT_thread_local_context";
+    "ALC_EXT_disconnect ALC_EXT_EFX ALC_EXT_thread_local_context "
+    "ALC_SOFTX_buffer_dedup ALC_SOFTX_effect_slot_stats "
+    "ALC_SOFTX_effect_memory ALC_SOFTX_device_stats ALC_SOFT_loopback";
 static const ALCint alcMajorVersion = 1;
 static const ALCint alcMinorVersion = 1;
 
@@ -362,7 +407,8 @@ static const ALchar alExtList[] =
     "AL_EXT_DOUBLE AL_EXT_EXPONENT_DISTANCE AL_EXT_FLOAT32 AL_EXT_IMA4 "
     "AL_EXT_LINEAR_DISTANCE AL_EXT_MCFORMATS AL_EXT_MULAW "
     "AL_EXT_MULAW_MCFORMATS AL_EXT_OFFSET AL_EXT_source_distance_model "
-    "AL_LOKI_quadriphonic AL_SOFT_buffer_sub_data AL_SOFT_loop_points";
+    "AL_EXT_STATIC_BUFFER AL_LOKI_quadriphonic AL_SOFT_buffer_sub_data "
+    "AL_SOFT_loop_points AL_SOFTX_async_buffer_data AL_SOFTX_databuffer_file";
 
 // Mixing Priority Level
 static ALint RTPrioLevel;
@@ -424,6 +470,7 @@ static void alc_init(void)
     InitializeCriticalSection(&g_csMutex);
     ALTHUNK_INIT();
     ReadALConfig();
+    ModulatorInitTables();
 
     tls_create(&LocalContext);
 
@@ -497,6 +544,7 @@ static void alc_init(void)
 
     for(i = 0;BackendList[i].Init;i++)
         BackendList[i].Init(&BackendList[i].Funcs);
+    BackendLoopback.Init(&BackendLoopback.Funcs);
 
     str = GetConfigValue(NULL, "excludefx", "");
     if(str[0])
@@ -509,6 +557,10 @@ static void alc_init(void)
             { "reverb", REVERB },
             { "echo", ECHO },
             { "modulator", MODULATOR },
+            { "equalizer", EQUALIZER },
+            { "compressor", COMPRESSOR },
+            { "chorus", CHORUS },
+            { "flanger", FLANGER },
             { NULL, 0 }
         };
         int n;
@@ -541,6 +593,7 @@ static void alc_deinit(void)
 
     for(i = 0;BackendList[i].Deinit;i++)
         BackendList[i].Deinit();
+    BackendLoopback.Deinit();
 
     tls_delete(LocalContext);
 
@@ -902,6 +955,61 @@ ALboolean DecomposeDevFormat(ALenum format, enum DevFmtChannels *chans,
     return AL_FALSE;
 }
 
+/* Converts the loopback device's channel and sample type enums to the
+ * device's formats */
+static ALCboolean DecomposeLoopbackFormat(ALCenum channels, ALCenum type,
+                                          enum DevFmtChannels *chans,
+                                          enum DevFmtType *dtype)
+{
+    switch(channels)
+    {
+        case ALC_MONO_SOFT:    *chans = DevFmtMono;   break;
+        case ALC_STEREO_SOFT:  *chans = DevFmtStereo; break;
+        case ALC_QUAD_SOFT:    *chans = DevFmtQuad;   break;
+        case ALC_5POINT1_SOFT: *chans = DevFmtX51;    break;
+        case ALC_6POINT1_SOFT: *chans = DevFmtX61;    break;
+        case ALC_7POINT1_SOFT: *chans = DevFmtX71;    break;
+        default: return ALC_FALSE;
+    }
+    switch(type)
+    {
+        case ALC_BYTE_SOFT:           *dtype = DevFmtByte;   break;
+        case ALC_UNSIGNED_BYTE_SOFT:  *dtype = DevFmtUByte;  break;
+        case ALC_SHORT_SOFT:          *dtype = DevFmtShort;  break;
+        case ALC_UNSIGNED_SHORT_SOFT: *dtype = DevFmtUShort; break;
+        case ALC_FLOAT_SOFT:          *dtype = DevFmtFloat;  break;
+        default: return ALC_FALSE;
+    }
+    return ALC_TRUE;
+}
+
+/* Checks that an attribute list gives the loopback device a supported
+ * frequency and format, which it has no defaults for */
+static ALCboolean IsValidLoopbackAttribs(const ALCint *attrList)
+{
+    ALCenum channels = 0, type = 0;
+    ALCint freq = 0;
+    enum DevFmtChannels chans;
+    enum DevFmtType dtype;
+    ALuint attrIdx;
+
+    if(!attrList)
+        return ALC_FALSE;
+
+    for(attrIdx = 0;attrList[attrIdx];attrIdx += 2)
+    {
+        if(attrList[attrIdx] == ALC_FREQUENCY)
+            freq = attrList[attrIdx + 1];
+        else if(attrList[attrIdx] == ALC_FORMAT_CHANNELS_SOFT)
+            channels = attrList[attrIdx + 1];
+        else if(attrList[attrIdx] == ALC_FORMAT_TYPE_SOFT)
+            type = attrList[attrIdx + 1];
+    }
+
+    return (freq >= 8000 &&
+            DecomposeLoopbackFormat(channels, type, &chans, &dtype));
+}
+
 /*
     IsDevice
 
@@ -964,6 +1072,7 @@ ALCvoid alcSetError(ALCdevice *device, ALenum errorCode)
 static ALCboolean UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
 {
     ALCuint freq, numMono, numStereo, numSends;
+    ALCenum channels = 0, type = 0;
     ALboolean running;
     ALuint oldRate;
     ALuint attrIdx;
@@ -994,7 +1103,7 @@ static ALCboolean UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
         while(attrList[attrIdx])
         {
             if(attrList[attrIdx] == ALC_FREQUENCY &&
-               !ConfigValueExists(NULL, "frequency"))
+               (device->IsLoopbackDevice || !ConfigValueExists(NULL, "frequency")))
             {
                 freq = attrList[attrIdx + 1];
                 if(freq < 8000)
@@ -1018,9 +1127,20 @@ static ALCboolean UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
                     numSends = MAX_SENDS;
             }
 
+            if(attrList[attrIdx] == ALC_FORMAT_CHANNELS_SOFT &&
+               device->IsLoopbackDevice)
+                channels = attrList[attrIdx + 1];
+            if(attrList[attrIdx] == ALC_FORMAT_TYPE_SOFT &&
+               device->IsLoopbackDevice)
+                type = attrList[attrIdx + 1];
+
             attrIdx += 2;
         }
 
+        if(device->IsLoopbackDevice)
+            DecomposeLoopbackFormat(channels, type, &device->FmtChans,
+                                    &device->FmtType);
+
         device->UpdateSize = (ALuint64)device->UpdateSize * freq /
                              device->Frequency;
 
@@ -1033,6 +1153,7 @@ static ALCboolean UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
     if(running)
         return ALC_TRUE;
 
+    aluResetDeviceStats(device);
     if(ALCdevice_ResetPlayback(device) == ALC_FALSE)
         return ALC_FALSE;
 
@@ -1096,6 +1217,16 @@ static ALCboolean UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
         device->Bs2b = NULL;
     }
 
+    if(device->UseLimiter)
+    {
+        if(!device->Limiter)
+            device->Limiter = CreateMasterLimiter();
+        if(!device->Limiter)
+            AL_PRINT("Failed to allocate the master limiter\n");
+        else
+            ResetMasterLimiter(device->Limiter, device->Frequency);
+    }
+
     if(ChannelsFromDevFmt(device->FmtChans) <= 2)
     {
         device->HeadDampen = GetConfigValueFloat(NULL, "head_dampen", DEFAULT_HEAD_DAMPEN);
@@ -1121,6 +1252,19 @@ ALCvoid SuspendContext(ALCcontext *pContext)
 }
 
 
+/*
+    TrySuspendContext
+
+    Thread-safe entry that doesn't wait. Returns ALC_FALSE if another thread
+    holds the lock
+*/
+ALCboolean TrySuspendContext(ALCcontext *pContext)
+{
+    (void)pContext;
+    return TryEnterCriticalSection(&g_csMutex) ? ALC_TRUE : ALC_FALSE;
+}
+
+
 /*
     ProcessContext
 
@@ -1189,6 +1333,7 @@ static ALvoid InitContext(ALCcontext *pContext)
     pContext->LastError = AL_NO_ERROR;
     pContext->Suspended = AL_FALSE;
     pContext->ActiveSourceCount = 0;
+    pContext->ActiveEffectSlotCount = 0;
     InitUIntMap(&pContext->SourceMap);
     InitUIntMap(&pContext->EffectSlotMap);
 
@@ -1656,6 +1801,126 @@ ALC_API ALCvoid ALC_APIENTRY alcGetIntegerv(ALCdevice *device,ALCenum param,ALsi
                 *data = device->Connected;
             break;
 
+        case ALC_BUFFER_BYTES_SAVED_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+            {
+                SuspendContext(NULL);
+                *data = BufferStoreBytesSaved(device);
+                ProcessContext(NULL);
+            }
+            break;
+
+        case ALC_EFFECT_SLOT_UPDATES_SKIPPED_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->SlotsSkippedRate;
+            break;
+
+        case ALC_EFFECT_MEMORY_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->EffectMemBytes;
+            break;
+
+        case ALC_DEVICE_STATS_SIZE_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = 15;
+            break;
+
+        case ALC_DEVICE_STATS_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else if(size < 15)
+                alcSetError(device, ALC_INVALID_VALUE);
+            else
+            {
+                int i = 0;
+
+                /* The lock keeps the mix times from the same second. The
+                 * backend's values are updated without it, so they can be
+                 * from different callbacks */
+                SuspendContext(NULL);
+                data[i++] = ALC_UNDERRUNS_SOFT;
+                data[i++] = device->Stats.Underruns;
+
+                data[i++] = ALC_MIX_TIME_MIN_SOFT;
+                data[i++] = device->Stats.MixTimeMin;
+
+                data[i++] = ALC_MIX_TIME_AVG_SOFT;
+                data[i++] = device->Stats.MixTimeAvg;
+
+                data[i++] = ALC_MIX_TIME_MAX_SOFT;
+                data[i++] = device->Stats.MixTimeMax;
+
+                data[i++] = ALC_BUFFERED_SAMPLES_SOFT;
+                data[i++] = device->Stats.BufferedSamples;
+
+                data[i++] = ALC_CALLBACK_JITTER_SOFT;
+                data[i++] = device->Stats.Jitter;
+
+                data[i++] = ALC_OUTPUT_LATENCY_SOFT;
+                data[i++] = device->Stats.Latency;
+
+                data[i++] = 0;
+                ProcessContext(NULL);
+            }
+            break;
+
+        case ALC_UNDERRUNS_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->Stats.Underruns;
+            break;
+
+        case ALC_MIX_TIME_MIN_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->Stats.MixTimeMin;
+            break;
+
+        case ALC_MIX_TIME_AVG_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->Stats.MixTimeAvg;
+            break;
+
+        case ALC_MIX_TIME_MAX_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->Stats.MixTimeMax;
+            break;
+
+        case ALC_BUFFERED_SAMPLES_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->Stats.BufferedSamples;
+            break;
+
+        case ALC_CALLBACK_JITTER_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->Stats.Jitter;
+            break;
+
+        case ALC_OUTPUT_LATENCY_SOFT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+                *data = device->Stats.Latency;
+            break;
+
         default:
             alcSetError(device, ALC_INVALID_ENUM);
             break;
@@ -1766,6 +2031,13 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
     // Reset Context Last Error code
     device->LastError = ALC_NO_ERROR;
 
+    if(device->IsLoopbackDevice && !IsValidLoopbackAttribs(attrList))
+    {
+        alcSetError(device, ALC_INVALID_VALUE);
+        ProcessContext(NULL);
+        return NULL;
+    }
+
     if(UpdateDeviceParams(device, attrList) == ALC_FALSE)
     {
         alcSetError(device, ALC_INVALID_DEVICE);
@@ -1877,6 +2149,11 @@ ALC_API ALCvoid ALC_APIENTRY alcDestroyContext(ALCcontext *context)
     context->MaxActiveSources = 0;
     context->ActiveSourceCount = 0;
 
+    free(context->ActiveEffectSlots);
+    context->ActiveEffectSlots = NULL;
+    context->MaxActiveEffectSlots = 0;
+    context->ActiveEffectSlotCount = 0;
+
     list = &g_pContextList;
     while(*list != context)
         list = &(*list)->next;
@@ -2122,29 +2399,23 @@ static ALenum GetFormatFromString(const char *str)
 
     Open the Device specified.
 */
-ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
+/*
+    InitDevice
+
+    Sets up the state shared by all playback devices, from the config
+*/
+static ALvoid InitDevice(ALCdevice *device)
 {
-    ALboolean bDeviceFound = AL_FALSE;
     const ALCchar *fmt;
-    ALCdevice *device;
-    ALint i;
-
-    if(deviceName && !deviceName[0])
-        deviceName = NULL;
-
-    device = calloc(1, sizeof(ALCdevice));
-    if(!device)
-    {
-        alcSetError(NULL, ALC_OUT_OF_MEMORY);
-        return NULL;
-    }
 
     //Validate device
     device->Connected = ALC_TRUE;
     device->IsCaptureDevice = AL_FALSE;
+    device->IsLoopbackDevice = AL_FALSE;
     device->LastError = ALC_NO_ERROR;
 
     device->Bs2b = NULL;
+    device->Limiter = NULL;
     device->szDeviceName = NULL;
 
     device->Contexts = NULL;
@@ -2155,6 +2426,67 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
     InitUIntMap(&device->FilterMap);
     InitUIntMap(&device->DatabufferMap);
 
+    device->MaxNoOfSources = GetConfigValueInt(NULL, "sources", 256);
+    if((ALint)device->MaxNoOfSources <= 0)
+        device->MaxNoOfSources = 256;
+
+    device->AuxiliaryEffectSlotMax = GetConfigValueInt(NULL, "slots", 4);
+    if((ALint)device->AuxiliaryEffectSlotMax <= 0)
+        device->AuxiliaryEffectSlotMax = 4;
+
+    device->NumStereoSources = 1;
+    device->NumMonoSources = device->MaxNoOfSources - device->NumStereoSources;
+
+    device->NumAuxSends = GetConfigValueInt(NULL, "sends", 1);
+    if(device->NumAuxSends > MAX_SENDS)
+        device->NumAuxSends = MAX_SENDS;
+
+    device->Bs2bLevel = GetConfigValueInt(NULL, "cf_level", 0);
+
+    device->DuplicateStereo = GetConfigValueBool(NULL, "stereodup", 1);
+
+    device->UseLimiter = GetConfigValueBool(NULL, "limiter", 0);
+
+    device->ShareBuffers = GetConfigValueBool(NULL, "dedup-buffers", 0);
+
+    fmt = GetConfigValue(NULL, "buffer-storage", "float");
+    if(strcasecmp(fmt, "short") == 0)
+        device->BufferStorage = BufferStorageShort;
+    else if(strcasecmp(fmt, "auto") == 0)
+        device->BufferStorage = BufferStorageAuto;
+    else
+        device->BufferStorage = BufferStorageFloat;
+    device->DitherBuffers = GetConfigValueBool(NULL, "buffer-dither", 0);
+
+    device->NumEffectThreads = GetConfigValueInt(NULL, "effect-threads", 0);
+    if((ALint)device->NumEffectThreads < 0)
+        device->NumEffectThreads = 0;
+    /* The mixer thread takes a share of the slots itself */
+    if(device->NumEffectThreads >= device->AuxiliaryEffectSlotMax)
+        device->NumEffectThreads = device->AuxiliaryEffectSlotMax-1;
+
+    device->HeadDampen = 0.0f;
+}
+
+ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
+{
+    ALboolean bDeviceFound = AL_FALSE;
+    const ALCchar *fmt;
+    ALCdevice *device;
+    ALint i;
+
+    if(deviceName && !deviceName[0])
+        deviceName = NULL;
+
+    device = calloc(1, sizeof(ALCdevice));
+    if(!device)
+    {
+        alcSetError(NULL, ALC_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    InitDevice(device);
+
     //Set output format
     device->Frequency = GetConfigValueInt(NULL, "frequency", SWMIXER_OUTPUT_RATE);
     if(device->Frequency < 8000)
@@ -2177,27 +2509,6 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
     if(device->UpdateSize <= 0)
         device->UpdateSize = 1024;
 
-    device->MaxNoOfSources = GetConfigValueInt(NULL, "sources", 256);
-    if((ALint)device->MaxNoOfSources <= 0)
-        device->MaxNoOfSources = 256;
-
-    device->AuxiliaryEffectSlotMax = GetConfigValueInt(NULL, "slots", 4);
-    if((ALint)device->AuxiliaryEffectSlotMax <= 0)
-        device->AuxiliaryEffectSlotMax = 4;
-
-    device->NumStereoSources = 1;
-    device->NumMonoSources = device->MaxNoOfSources - device->NumStereoSources;
-
-    device->NumAuxSends = GetConfigValueInt(NULL, "sends", 1);
-    if(device->NumAuxSends > MAX_SENDS)
-        device->NumAuxSends = MAX_SENDS;
-
-    device->Bs2bLevel = GetConfigValueInt(NULL, "cf_level", 0);
-
-    device->DuplicateStereo = GetConfigValueBool(NULL, "stereodup", 1);
-
-    device->HeadDampen = 0.0f;
-
     // Find a playback device to open
     SuspendContext(NULL);
     for(i = 0;BackendList[i].Init;i++)
@@ -2222,6 +2533,12 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName)
         free(device);
         device = NULL;
     }
+    else if(!StartEffectThreads(device))
+    {
+        AL_PRINT("Failed to start %u effect thread(s), processing serially\n",
+                 device->NumEffectThreads);
+        device->NumEffectThreads = 0;
+    }
 
     return device;
 }
@@ -2263,6 +2580,9 @@ ALC_API ALCboolean ALC_APIENTRY alcCloseDevice(ALCdevice *pDevice)
     }
     ALCdevice_ClosePlayback(pDevice);
 
+    StopBufferThread(pDevice);
+    StopEffectThreads(pDevice);
+
     if(pDevice->BufferMap.size > 0)
     {
 #ifdef _DEBUG
@@ -2302,6 +2622,9 @@ ALC_API ALCboolean ALC_APIENTRY alcCloseDevice(ALCdevice *pDevice)
     free(pDevice->Bs2b);
     pDevice->Bs2b = NULL;
 
+    free(pDevice->Limiter);
+    pDevice->Limiter = NULL;
+
     free(pDevice->szDeviceName);
     pDevice->szDeviceName = NULL;
 
@@ -2316,6 +2639,107 @@ ALC_API ALCboolean ALC_APIENTRY alcCloseDevice(ALCdevice *pDevice)
 }
 
 
+/*
+    alcLoopbackOpenDeviceSOFT
+
+    Open a device that's rendered on demand with alcRenderSamplesSOFT, instead
+    of playing to an output
+*/
+ALC_API ALCdevice* ALC_APIENTRY alcLoopbackOpenDeviceSOFT(const ALCchar *deviceName)
+{
+    ALCdevice *device;
+
+    device = calloc(1, sizeof(ALCdevice));
+    if(!device)
+    {
+        alcSetError(NULL, ALC_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    InitDevice(device);
+    device->IsLoopbackDevice = AL_TRUE;
+
+    // The format is set when creating a context
+    device->Frequency = SWMIXER_OUTPUT_RATE;
+    device->FmtChans = DevFmtStereo;
+    device->FmtType = DevFmtShort;
+
+    // Only used for reporting, since the app decides how much to render
+    device->NumUpdates = 1;
+    device->UpdateSize = 1024;
+
+    device->Funcs = &BackendLoopback.Funcs;
+    if(!ALCdevice_OpenPlayback(device, deviceName))
+    {
+        alcSetError(NULL, ALC_INVALID_VALUE);
+        free(device);
+        return NULL;
+    }
+
+    SuspendContext(NULL);
+    device->next = g_pDeviceList;
+    g_pDeviceList = device;
+    g_ulDeviceCount++;
+    ProcessContext(NULL);
+
+    if(!StartEffectThreads(device))
+    {
+        AL_PRINT("Failed to start %u effect thread(s), processing serially\n",
+                 device->NumEffectThreads);
+        device->NumEffectThreads = 0;
+    }
+
+    return device;
+}
+
+/*
+    alcIsRenderFormatSupportedSOFT
+
+    Determines if the loopback device can render the given format
+*/
+ALC_API ALCboolean ALC_APIENTRY alcIsRenderFormatSupportedSOFT(ALCdevice *device, ALCsizei freq, ALCenum channels, ALCenum type)
+{
+    enum DevFmtChannels chans;
+    enum DevFmtType dtype;
+
+    if(!IsDevice(device) || !device->IsLoopbackDevice)
+    {
+        alcSetError(device, ALC_INVALID_DEVICE);
+        return ALC_FALSE;
+    }
+    if(freq <= 0)
+    {
+        alcSetError(device, ALC_INVALID_VALUE);
+        return ALC_FALSE;
+    }
+
+    return (freq >= 8000 &&
+            DecomposeLoopbackFormat(channels, type, &chans, &dtype));
+}
+
+/*
+    alcRenderSamplesSOFT
+
+    Mixes the given number of sample frames from the loopback device into the
+    buffer, in the format its context was created with
+*/
+ALC_API void ALC_APIENTRY alcRenderSamplesSOFT(ALCdevice *device, ALCvoid *buffer, ALCsizei samples)
+{
+    if(!IsDevice(device) || !device->IsLoopbackDevice)
+    {
+        alcSetError(device, ALC_INVALID_DEVICE);
+        return;
+    }
+    if(samples < 0 || (samples > 0 && buffer == NULL))
+    {
+        alcSetError(device, ALC_INVALID_VALUE);
+        return;
+    }
+
+    aluMixData(device, buffer, samples);
+}
+
+
 static void ReleaseALC(void)
 {
     free(alcDeviceList); alcDeviceList = NULL;
@@ -76,15 +76,67 @@ static __inline ALvoid aluMatrixVector(ALfloat *vector,ALfloat w,ALfloat matrix[
 }
 
 
+/* Sets up the low-shelf used by high-pass and band-pass filters, and picks the
+ * mixer kernel. The cheaper kernels are used when a path doesn't need the
+ * shelf, or doesn't need the low-pass. */
+static ALvoid CalcShelfParams(ALsource *ALSource, ALfloat DryGainLF, const ALfloat *WetGainLF, ALint NumSends, ALuint Frequency)
+{
+    ALboolean needLF, needHF;
+    filter_t OldType;
+    ALfloat a;
+    ALint i;
+
+    /* The shelf is a single one-pole filter, so the gain is applied as-is */
+    a = exp(-2.0*M_PI * HIGHPASSFREQCUTOFF / Frequency);
+
+    ALSource->Params.lfFilter.coeff = a;
+    ALSource->Params.lfScale = 1.0f - DryGainLF;
+    needLF = (DryGainLF < 1.0f);
+    needHF = (ALSource->Params.iirFilter.coeff != 0.0f);
+    for(i = 0;i < NumSends;i++)
+    {
+        ALSource->Params.Send[i].lfFilter.coeff = a;
+        ALSource->Params.Send[i].lfScale = 1.0f - WetGainLF[i];
+        needLF |= (WetGainLF[i] < 1.0f);
+        needHF |= (ALSource->Params.Send[i].iirFilter.coeff != 0.0f);
+    }
+
+    OldType = ALSource->Params.FilterType;
+    if(!needLF)
+        ALSource->Params.FilterType = LOWPASS_FILTER;
+    else if(!needHF)
+        ALSource->Params.FilterType = HIGHPASS_FILTER;
+    else
+        ALSource->Params.FilterType = BANDPASS_FILTER;
+
+    /* A stage the old kernel skipped holds history from whenever it last ran,
+     * so clear it before the new kernel picks it up again */
+    if(OldType == HIGHPASS_FILTER && ALSource->Params.FilterType != HIGHPASS_FILTER)
+    {
+        memset(ALSource->Params.history, 0, sizeof(ALSource->Params.history));
+        for(i = 0;i < NumSends;i++)
+            memset(ALSource->Params.Send[i].history, 0,
+                   sizeof(ALSource->Params.Send[i].history));
+    }
+    if(OldType == LOWPASS_FILTER && ALSource->Params.FilterType != LOWPASS_FILTER)
+    {
+        memset(ALSource->Params.lfHistory, 0, sizeof(ALSource->Params.lfHistory));
+        for(i = 0;i < NumSends;i++)
+            memset(ALSource->Params.Send[i].lfHistory, 0,
+                   sizeof(ALSource->Params.Send[i].lfHistory));
+    }
+}
+
 ALvoid CalcNonAttnSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
 {
     ALfloat SourceVolume,ListenerGain,MinVolume,MaxVolume;
     ALbufferlistitem *BufferListItem;
     enum DevFmtChannels DevChans;
     enum FmtChannels Channels;
-    ALfloat DryGain, DryGainHF;
+    ALfloat DryGain, DryGainHF, DryGainLF;
     ALfloat WetGain[MAX_SENDS];
     ALfloat WetGainHF[MAX_SENDS];
+    ALfloat WetGainLF[MAX_SENDS];
     ALint NumSends, Frequency;
     ALboolean DupStereo;
     ALfloat Pitch;
@@ -141,6 +193,7 @@ ALvoid CalcNonAttnSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
     DryGain = __min(DryGain,MaxVolume);
     DryGain = __max(DryGain,MinVolume);
     DryGainHF = 1.0f;
+    DryGainLF = 1.0f;
 
     switch(ALSource->DirectFilter.type)
     {
@@ -148,6 +201,15 @@ ALvoid CalcNonAttnSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
             DryGain *= ALSource->DirectFilter.Gain;
             DryGainHF *= ALSource->DirectFilter.GainHF;
             break;
+        case AL_FILTER_HIGHPASS:
+            DryGain *= ALSource->DirectFilter.Gain;
+            DryGainLF *= ALSource->DirectFilter.GainLF;
+            break;
+        case AL_FILTER_BANDPASS:
+            DryGain *= ALSource->DirectFilter.Gain;
+            DryGainHF *= ALSource->DirectFilter.GainHF;
+            DryGainLF *= ALSource->DirectFilter.GainLF;
+            break;
     }
 
     for(i = 0;i < MAXCHANNELS;i++)
@@ -257,6 +319,7 @@ ALvoid CalcNonAttnSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
         WetGain[i] = __min(WetGain[i],MaxVolume);
         WetGain[i] = __max(WetGain[i],MinVolume);
         WetGainHF[i] = 1.0f;
+        WetGainLF[i] = 1.0f;
 
         switch(ALSource->Send[i].WetFilter.type)
         {
@@ -264,6 +327,15 @@ ALvoid CalcNonAttnSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
                 WetGain[i] *= ALSource->Send[i].WetFilter.Gain;
                 WetGainHF[i] *= ALSource->Send[i].WetFilter.GainHF;
                 break;
+            case AL_FILTER_HIGHPASS:
+                WetGain[i] *= ALSource->Send[i].WetFilter.Gain;
+                WetGainLF[i] *= ALSource->Send[i].WetFilter.GainLF;
+                break;
+            case AL_FILTER_BANDPASS:
+                WetGain[i] *= ALSource->Send[i].WetFilter.Gain;
+                WetGainHF[i] *= ALSource->Send[i].WetFilter.GainHF;
+                WetGainLF[i] *= ALSource->Send[i].WetFilter.GainLF;
+                break;
         }
 
         ALSource->Params.Send[i].WetGain = WetGain[i] * ListenerGain;
@@ -284,6 +356,8 @@ ALvoid CalcNonAttnSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
         ALfloat a = lpCoeffCalc(WetGainHF[i]*WetGainHF[i], cw);
         ALSource->Params.Send[i].iirFilter.coeff = a;
     }
+
+    CalcShelfParams(ALSource, DryGainLF, WetGainLF, NumSends, Frequency);
 }
 
 ALvoid CalcSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
@@ -303,8 +377,10 @@ ALvoid CalcSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
     ALfloat RoomRolloff[MAX_SENDS];
     ALfloat DryGain;
     ALfloat DryGainHF;
+    ALfloat DryGainLF;
     ALfloat WetGain[MAX_SENDS];
     ALfloat WetGainHF[MAX_SENDS];
+    ALfloat WetGainLF[MAX_SENDS];
     ALfloat DirGain, AmbientGain;
     const ALfloat *SpeakerGain;
     ALfloat Pitch;
@@ -315,8 +391,12 @@ ALvoid CalcSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
     ALfloat cw;
 
     DryGainHF = 1.0f;
+    DryGainLF = 1.0f;
     for(i = 0;i < MAX_SENDS;i++)
+    {
         WetGainHF[i] = 1.0f;
+        WetGainLF[i] = 1.0f;
+    }
 
     //Get context properties
     DopplerFactor   = ALContext->DopplerFactor * ALSource->DopplerFactor;
@@ -579,6 +659,15 @@ ALvoid CalcSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
                 WetGain[i] *= ALSource->Send[i].WetFilter.Gain;
                 WetGainHF[i] *= ALSource->Send[i].WetFilter.GainHF;
                 break;
+            case AL_FILTER_HIGHPASS:
+                WetGain[i] *= ALSource->Send[i].WetFilter.Gain;
+                WetGainLF[i] *= ALSource->Send[i].WetFilter.GainLF;
+                break;
+            case AL_FILTER_BANDPASS:
+                WetGain[i] *= ALSource->Send[i].WetFilter.Gain;
+                WetGainHF[i] *= ALSource->Send[i].WetFilter.GainHF;
+                WetGainLF[i] *= ALSource->Send[i].WetFilter.GainLF;
+                break;
         }
         ALSource->Params.Send[i].WetGain = WetGain[i] * ListenerGain;
     }
@@ -590,6 +679,15 @@ ALvoid CalcSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
             DryGain *= ALSource->DirectFilter.Gain;
             DryGainHF *= ALSource->DirectFilter.GainHF;
             break;
+        case AL_FILTER_HIGHPASS:
+            DryGain *= ALSource->DirectFilter.Gain;
+            DryGainLF *= ALSource->DirectFilter.GainLF;
+            break;
+        case AL_FILTER_BANDPASS:
+            DryGain *= ALSource->DirectFilter.Gain;
+            DryGainHF *= ALSource->DirectFilter.GainHF;
+            DryGainLF *= ALSource->DirectFilter.GainLF;
+            break;
     }
     DryGain *= ListenerGain;
 
@@ -687,6 +785,8 @@ ALvoid CalcSourceParams(ALsource *ALSource, const ALCcontext *ALContext)
          * base gain (square root of the squared gain) */
         ALSource->Params.Send[i].iirFilter.coeff = lpCoeffCalc(WetGainHF[i], cw);
     }
+
+    CalcShelfParams(ALSource, DryGainLF, WetGainLF, NumSends, Frequency);
 }
 
 
@@ -867,15 +967,244 @@ DECL_TEMPLATE(ALbyte, aluF2B)
 
 #undef DECL_TEMPLATE
 
+static const ALfloat SLOT_SLEEP_LEVEL = 1.0f/65536.0f;
+
+/* Tracks the estimated tail level of an effect slot given the peak of its
+ * input for this update, and returns whether the slot needs processing.  A
+ * slot sleeps once its input and tail are both below SLOT_SLEEP_LEVEL (half
+ * of a 16-bit LSB), and wakes as soon as a send feeds it something louder.
+ */
+static ALboolean UpdateTailLevel(ALeffectslot *Slot, ALfloat peak, ALuint frequency, ALuint SamplesToDo)
+{
+    ALfloat level = peak * Slot->TailGain;
+    ALuint decay;
+
+    if(level >= SLOT_SLEEP_LEVEL)
+    {
+        Slot->TailLevel = __max(Slot->TailLevel, level);
+        Slot->TailHoldCount = (ALuint)(Slot->TailHold * frequency);
+    }
+    if(Slot->TailLevel < SLOT_SLEEP_LEVEL)
+        return AL_FALSE;
+
+    // Hold the tail level for the effect's initial delay, then decay it for
+    // the rest of the update.
+    decay = SamplesToDo;
+    if(Slot->TailHoldCount >= decay)
+    {
+        Slot->TailHoldCount -= decay;
+        decay = 0;
+    }
+    else
+    {
+        decay -= Slot->TailHoldCount;
+        Slot->TailHoldCount = 0;
+    }
+
+    if(decay > 0 && Slot->TailDecay >= 0.0f)
+    {
+        if(Slot->TailDecay > 0.0f)
+            Slot->TailLevel *= aluPow(10.0f, -3.0f * decay /
+                                             (Slot->TailDecay * frequency));
+        else
+            Slot->TailLevel = 0.0f;
+    }
+    return AL_TRUE;
+}
+
+
+/* Optional worker threads for processing effect slots in parallel. Each slot
+ * renders into its own accumulator (prefilled with -0.0, which leaves any sum
+ * unchanged), and the mixer then adds the accumulators into the dry buffer in
+ * slot order. Since every effect adds to each output sample at most once,
+ * this gives the same result as processing the slots one after another.
+ */
+typedef struct EffectThread {
+    struct EffectThreadPool *Pool;
+    ALuint Index;
+    ALvoid *Start;
+    ALvoid *Thread;
+} EffectThread;
+
+struct EffectThreadPool {
+    EffectThread *Threads;
+    ALuint NumThreads;
+    ALvoid *Done;
+    volatile ALboolean Kill;
+
+    // Per-slot output accumulators
+    ALfloat (*Output)[BUFFERSIZE][MAXCHANNELS];
+    ALuint MaxSlots;
+
+    // The current job; slot i is handled by thread i%Stride, where thread 0
+    // is the mixer itself
+    ALeffectslot **Slots;
+    ALuint NumSlots;
+    ALuint Stride;
+    ALuint SamplesToDo;
+};
+
+static ALvoid ProcessSlotRange(struct EffectThreadPool *pool, ALuint index)
+{
+    ALeffectslot *ALEffectSlot;
+    ALfloat (*Output)[MAXCHANNELS];
+    ALuint SamplesToDo = pool->SamplesToDo;
+    ALuint i, c;
+
+    for(;index < pool->NumSlots;index += pool->Stride)
+    {
+        ALEffectSlot = pool->Slots[index];
+        Output = pool->Output[index];
+
+        for(i = 0;i < SamplesToDo;i++)
+        {
+            for(c = 0;c < MAXCHANNELS;c++)
+                Output[i][c] = -0.0f;
+        }
+        ALEffect_Process(ALEffectSlot->EffectState, ALEffectSlot,
+                         SamplesToDo, ALEffectSlot->WetBuffer, Output);
+
+        for(i = 0;i < SamplesToDo;i++)
+            ALEffectSlot->WetBuffer[i] = 0.0f;
+    }
+}
+
+static ALuint EffectThreadProc(ALvoid *ptr)
+{
+    EffectThread *self = (EffectThread*)ptr;
+    struct EffectThreadPool *pool = self->Pool;
+
+    /* The rounding mode is per-thread, so match what the mixer uses */
+#if defined(HAVE_FESETROUND)
+    fesetround(FE_TOWARDZERO);
+#elif defined(HAVE__CONTROLFP)
+    _controlfp(_RC_CHOP, _MCW_RC);
+#endif
+
+    while(1)
+    {
+        WaitSem(self->Start);
+        if(pool->Kill)
+            break;
+
+        ProcessSlotRange(pool, self->Index);
+        PostSem(pool->Done);
+    }
+
+    return 0;
+}
+
+static ALvoid ProcessSlotsParallel(struct EffectThreadPool *pool, ALeffectslot **Slots, ALuint NumSlots, ALuint SamplesToDo, ALfloat (*DryBuffer)[MAXCHANNELS])
+{
+    ALfloat sample;
+    ALuint i, c, s;
+
+    pool->Slots = Slots;
+    pool->NumSlots = NumSlots;
+    pool->Stride = __min(pool->NumThreads+1, NumSlots);
+    pool->SamplesToDo = SamplesToDo;
+
+    for(i = 1;i < pool->Stride;i++)
+        PostSem(pool->Threads[i-1].Start);
+    ProcessSlotRange(pool, 0);
+    for(i = 1;i < pool->Stride;i++)
+        WaitSem(pool->Done);
+
+    for(i = 0;i < SamplesToDo;i++)
+    {
+        for(c = 0;c < MAXCHANNELS;c++)
+        {
+            sample = DryBuffer[i][c];
+            for(s = 0;s < NumSlots;s++)
+                sample += pool->Output[s][i][c];
+            DryBuffer[i][c] = sample;
+        }
+    }
+}
+
+ALboolean StartEffectThreads(ALCdevice *device)
+{
+    struct EffectThreadPool *pool;
+    EffectThread *thread;
+    ALuint i;
+
+    if(device->NumEffectThreads == 0 || device->EffectPool)
+        return AL_TRUE;
+
+    pool = calloc(1, sizeof(*pool));
+    if(!pool)
+        return AL_FALSE;
+    device->EffectPool = pool;
+
+    pool->MaxSlots = device->AuxiliaryEffectSlotMax;
+    pool->Output = malloc(pool->MaxSlots * sizeof(*pool->Output));
+    pool->Threads = calloc(device->NumEffectThreads, sizeof(*pool->Threads));
+    pool->Done = CreateSem(0);
+    if(!pool->Output || !pool->Threads || !pool->Done)
+    {
+        StopEffectThreads(device);
+        return AL_FALSE;
+    }
+
+    for(i = 0;i < device->NumEffectThreads;i++)
+    {
+        thread = &pool->Threads[i];
+        thread->Pool = pool;
+        thread->Index = i+1;
+        thread->Start = CreateSem(0);
+        if(thread->Start)
+            thread->Thread = StartThread(EffectThreadProc, thread);
+        if(!thread->Thread)
+        {
+            if(thread->Start)
+                DestroySem(thread->Start);
+            StopEffectThreads(device);
+            return AL_FALSE;
+        }
+        pool->NumThreads++;
+    }
+
+    return AL_TRUE;
+}
+
+ALvoid StopEffectThreads(ALCdevice *device)
+{
+    struct EffectThreadPool *pool = device->EffectPool;
+    ALuint i;
+
+    if(!pool)
+        return;
+
+    pool->Kill = AL_TRUE;
+    for(i = 0;i < pool->NumThreads;i++)
+    {
+        PostSem(pool->Threads[i].Start);
+        StopThread(pool->Threads[i].Thread);
+        DestroySem(pool->Threads[i].Start);
+    }
+
+    if(pool->Done)
+        DestroySem(pool->Done);
+    free(pool->Threads);
+    free(pool->Output);
+    free(pool);
+    device->EffectPool = NULL;
+}
+
 ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
 {
     ALuint SamplesToDo;
     ALeffectslot *ALEffectSlot;
     ALCcontext **ctx, **ctx_end;
     ALsource **src, **src_end;
+    ALeffectslot **slot, **slot_end;
+    ALuint SlotsSkipped;
+    ALCdeviceStats *stats;
+    ALuint64 mixStart;
+    ALuint mixTime;
+    ALsizei total;
     int fpuState;
     ALuint i, c;
-    ALsizei e;
 
 #if defined(HAVE_FESETROUND)
     fpuState = fegetround();
@@ -886,6 +1215,9 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
     (void)fpuState;
 #endif
 
+    mixStart = GetMicroTime();
+    total = size;
+
     while(size > 0)
     {
         /* Setup variables */
@@ -894,7 +1226,19 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
         /* Clear mixing buffer */
         memset(device->DryBuffer, 0, SamplesToDo*MAXCHANNELS*sizeof(ALfloat));
 
+        SlotsSkipped = 0;
+
         SuspendContext(NULL);
+        /* Publish the last second's mix times, now that the lock is held */
+        stats = &device->Stats;
+        if(stats->MixDone)
+        {
+            stats->MixTimeMin = stats->MixDoneMin;
+            stats->MixTimeAvg = stats->MixDoneAvg;
+            stats->MixTimeMax = stats->MixDoneMax;
+            stats->MixDone = AL_FALSE;
+        }
+
         ctx = device->Contexts;
         ctx_end = ctx + device->NumContexts;
         while(ctx != ctx_end)
@@ -919,18 +1263,36 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
                 }
 
                 MixSource(*src, device, SamplesToDo);
+
+                /* Make sure the slots this source sends to get processed */
+                for(i = 0;i < device->NumAuxSends;i++)
+                {
+                    ALEffectSlot = (*src)->Send[i].Slot;
+                    if(ALEffectSlot && !ALEffectSlot->Active)
+                    {
+                        ALEffectSlot->Active = AL_TRUE;
+                        (*ctx)->ActiveEffectSlots[(*ctx)->ActiveEffectSlotCount++] = ALEffectSlot;
+                    }
+                }
                 src++;
             }
 
-            /* effect slot processing */
-            for(e = 0;e < (*ctx)->EffectSlotMap.size;e++)
+            /* effect slot processing; first update the slots' input and put
+             * any that fell silent to sleep */
+            slot = (*ctx)->ActiveEffectSlots;
+            slot_end = slot + (*ctx)->ActiveEffectSlotCount;
+            SlotsSkipped += (*ctx)->EffectSlotMap.size;
+            while(slot != slot_end)
             {
-                ALEffectSlot = (*ctx)->EffectSlotMap.array[e].value;
+                ALfloat peak = 0.0f;
+
+                ALEffectSlot = *slot;
 
                 for(i = 0;i < SamplesToDo;i++)
                 {
                     ALEffectSlot->ClickRemoval[0] -= ALEffectSlot->ClickRemoval[0] / 256.0f;
                     ALEffectSlot->WetBuffer[i] += ALEffectSlot->ClickRemoval[0];
+                    peak = __max(peak, aluFabs(ALEffectSlot->WetBuffer[i]));
                 }
                 for(i = 0;i < 1;i++)
                 {
@@ -938,12 +1300,45 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
                     ALEffectSlot->PendingClicks[i] = 0.0f;
                 }
 
-                ALEffect_Process(ALEffectSlot->EffectState, ALEffectSlot,
-                                 SamplesToDo, ALEffectSlot->WetBuffer,
-                                 device->DryBuffer);
+                if(!UpdateTailLevel(ALEffectSlot, peak, device->Frequency, SamplesToDo))
+                {
+                    /* Asleep, so drop it from the list until a source sends
+                     * to it again */
+                    if(peak != 0.0f)
+                    {
+                        for(i = 0;i < SamplesToDo;i++)
+                            ALEffectSlot->WetBuffer[i] = 0.0f;
+                    }
+                    ALEffectSlot->Active = AL_FALSE;
+                    --((*ctx)->ActiveEffectSlotCount);
+                    *slot = *(--slot_end);
+                    continue;
+                }
+                slot++;
+            }
 
-                for(i = 0;i < SamplesToDo;i++)
-                    ALEffectSlot->WetBuffer[i] = 0.0f;
+            /* then run the ones still awake */
+            SlotsSkipped -= (*ctx)->ActiveEffectSlotCount;
+            if(device->EffectPool && (*ctx)->ActiveEffectSlotCount > 1)
+                ProcessSlotsParallel(device->EffectPool,
+                                     (*ctx)->ActiveEffectSlots,
+                                     (*ctx)->ActiveEffectSlotCount,
+                                     SamplesToDo, device->DryBuffer);
+            else
+            {
+                slot = (*ctx)->ActiveEffectSlots;
+                while(slot != slot_end)
+                {
+                    ALEffectSlot = *slot;
+
+                    ALEffect_Process(ALEffectSlot->EffectState, ALEffectSlot,
+                                     SamplesToDo, ALEffectSlot->WetBuffer,
+                                     device->DryBuffer);
+
+                    for(i = 0;i < SamplesToDo;i++)
+                        ALEffectSlot->WetBuffer[i] = 0.0f;
+                    slot++;
+                }
             }
 
             ProcessContext(*ctx);
@@ -951,6 +1346,19 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
         }
         ProcessContext(NULL);
 
+        /* Keep a running count of how many effect slot updates were skipped
+         * over the last second */
+        device->SlotsSkipped += SlotsSkipped;
+        device->SlotStatSamples += SamplesToDo;
+        if(device->SlotStatSamples >= device->Frequency)
+        {
+            device->SlotsSkippedRate = (ALuint)((ALuint64)device->SlotsSkipped *
+                                                device->Frequency /
+                                                device->SlotStatSamples);
+            device->SlotsSkipped = 0;
+            device->SlotStatSamples = 0;
+        }
+
         //Post processing loop
         for(i = 0;i < SamplesToDo;i++)
         {
@@ -966,6 +1374,9 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
             device->PendingClicks[i] = 0.0f;
         }
 
+        if(device->Limiter)
+            ApplyMasterLimiter(device->Limiter, device->DryBuffer, SamplesToDo);
+
         switch(device->FmtType)
         {
             case DevFmtByte:
@@ -988,6 +1399,31 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
         size -= SamplesToDo;
     }
 
+    /* Keep the shortest, average and longest time taken to mix over the last
+     * second. Only the mixer uses the running values, so they're updated
+     * without the lock, and the results are published on the next mix */
+    mixTime = (ALuint)(GetMicroTime() - mixStart);
+    stats = &device->Stats;
+
+    if(stats->MixCount == 0 || mixTime < stats->MixMin)
+        stats->MixMin = mixTime;
+    if(mixTime > stats->MixMax)
+        stats->MixMax = mixTime;
+    stats->MixTotal += mixTime;
+    stats->MixCount++;
+    stats->MixSamples += total;
+    if(stats->MixSamples >= device->Frequency)
+    {
+        stats->MixDoneMin = stats->MixMin;
+        stats->MixDoneAvg = (ALuint)(stats->MixTotal / stats->MixCount);
+        stats->MixDoneMax = stats->MixMax;
+        stats->MixDone = AL_TRUE;
+        stats->MixMax = 0;
+        stats->MixTotal = 0;
+        stats->MixCount = 0;
+        stats->MixSamples = 0;
+    }
+
 #if defined(HAVE_FESETROUND)
     fesetround(fpuState);
 #elif defined(HAVE__CONTROLFP)
@@ -996,6 +1432,58 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
 }
 
 
+/* Called by a backend each time the device takes samples from it, with how
+ * many it took, how many are still buffered ahead of the device, and the
+ * total output latency (both in sample frames). Only the backend's own thread
+ * or callback should call this. */
+ALvoid aluDeviceCallback(ALCdevice *device, ALuint samples, ALuint buffered, ALuint latency)
+{
+    ALCdeviceStats *stats = &device->Stats;
+    ALuint64 now = GetMicroTime();
+
+    /* The jitter is how far the time since the last callback is from the
+     * length of the samples it took */
+    if(stats->LastCallbackSamples > 0)
+    {
+        ALuint64 expected, interval;
+        ALuint jitter;
+
+        expected = (ALuint64)stats->LastCallbackSamples * 1000000 /
+                   device->Frequency;
+        interval = now - stats->LastCallback;
+        jitter = (ALuint)((interval > expected) ? (interval-expected) :
+                                                  (expected-interval));
+        if(jitter > stats->CallbackJitter)
+            stats->CallbackJitter = jitter;
+
+        stats->CallbackSamples += samples;
+        if(stats->CallbackSamples >= device->Frequency)
+        {
+            stats->Jitter = stats->CallbackJitter;
+            stats->CallbackJitter = 0;
+            stats->CallbackSamples = 0;
+        }
+    }
+    stats->LastCallback = now;
+    stats->LastCallbackSamples = samples;
+
+    stats->BufferedSamples = buffered;
+    stats->Latency = latency;
+}
+
+/* Called by a backend when the device ran out of samples to play */
+ALvoid aluDeviceUnderrun(ALCdevice *device)
+{
+    device->Stats.Underruns++;
+}
+
+/* Clears the statistics, for when the device is (re)started */
+ALvoid aluResetDeviceStats(ALCdevice *device)
+{
+    memset(&device->Stats, 0, sizeof(device->Stats));
+}
+
+
 ALvoid aluHandleDisconnect(ALCdevice *device)
 {
     ALuint i;
@@ -0,0 +1,274 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "alMain.h"
+#include "alFilter.h"
+#include "alAuxEffectSlot.h"
+#include "alError.h"
+#include "alu.h"
+
+
+/* The LFO is only evaluated at the edges of each block, and the delay is
+ * linearly interpolated between them. Even at the maximum rate, a block is a
+ * small part of the LFO's period, so the difference isn't audible.
+ */
+#define LFO_BLOCK_SIZE 64
+
+/* Chorus and flanger are the same effect: each output channel is a delay line
+ * whose length is swept by an LFO, with some of its output fed back in. They
+ * only differ in their parameter ranges.
+ */
+typedef struct ALchorusState {
+    // Must be first in all effects!
+    ALeffectState state;
+
+    // Allocated from the device's effect memory, holding the left and right
+    // delay lines back to back
+    ALCdevice *Device;
+    ALfloat *SampleBuffer;
+    ALuint BufferLength;
+    ALuint Offset;
+
+    // Longest delay this effect type allows, in seconds
+    ALfloat MaxDelay;
+
+    ALint Waveform;
+    // LFO position as a fraction of its period, how far it moves each
+    // sample, and how far ahead the right channel's LFO is
+    ALfloat LfoPos;
+    ALfloat LfoStep;
+    ALfloat LfoOffset;
+
+    // The center delay and how far the LFO sweeps it, in samples
+    ALfloat Delay;
+    ALfloat Depth;
+    ALfloat Feedback;
+
+    ALfloat Gain[MAXCHANNELS];
+
+    ALfloat Buffer[2][LFO_BLOCK_SIZE];
+} ALchorusState;
+
+
+/* Returns the LFO's level, from -1 to +1, at the given point in its period.
+ * The flanger's waveform values are the same as the chorus'.
+ */
+static __inline ALfloat LfoLevel(ALint waveform, ALfloat pos)
+{
+    if(waveform == AL_CHORUS_WAVEFORM_SINUSOID)
+        return sin(2.0*M_PI * pos);
+    if(pos < 0.25f)
+        return pos*4.0f;
+    if(pos < 0.75f)
+        return 2.0f - pos*4.0f;
+    return pos*4.0f - 4.0f;
+}
+
+static __inline ALfloat WrapLfoPos(ALfloat pos)
+{
+    return pos - floor(pos);
+}
+
+/* Runs a block through one delay line. The delay (in samples) moves by
+ * delayStep each sample, and the output is linearly interpolated between
+ * the two nearest samples. The delay must be at least 1.
+ */
+static ALvoid ModulatedDelay(ALfloat *line, ALuint mask, ALuint offset, ALfloat delay, ALfloat delayStep, ALfloat feedback, const ALfloat *in, ALfloat *out, ALuint todo)
+{
+    ALfloat s0, s1, frac, samp;
+    ALuint i, idx;
+
+    for(i = 0;i < todo;i++)
+    {
+        idx = (ALuint)delay;
+        frac = delay - idx;
+
+        s0 = line[(offset-idx)   & mask];
+        s1 = line[(offset-idx-1) & mask];
+        samp = s0 + (s1-s0)*frac;
+
+        line[offset&mask] = in[i] + samp*feedback;
+        out[i] = samp;
+
+        offset++;
+        delay += delayStep;
+    }
+}
+
+
+static ALvoid ChorusDestroy(ALeffectState *effect)
+{
+    ALchorusState *state = (ALchorusState*)effect;
+    if(state)
+    {
+        if(state->Device)
+            FreeEffectSamples(state->Device, state->SampleBuffer,
+                              state->BufferLength*2);
+        state->SampleBuffer = NULL;
+        free(state);
+    }
+}
+
+static ALboolean ChorusDeviceUpdate(ALeffectState *effect, ALCdevice *Device)
+{
+    ALchorusState *state = (ALchorusState*)effect;
+    ALuint maxlen, i;
+
+    // The LFO can sweep the delay up to twice the center delay, plus one for
+    // interpolation. Use a power of 2 so the offsets can be masked
+    maxlen = (ALuint)(state->MaxDelay*2.0f * Device->Frequency) + 2;
+    maxlen = NextPowerOf2(maxlen);
+
+    state->Device = Device;
+    if(maxlen != state->BufferLength)
+    {
+        ALfloat *temp;
+
+        temp = AllocEffectSamples(Device, maxlen*2);
+        if(!temp)
+            return AL_FALSE;
+        FreeEffectSamples(Device, state->SampleBuffer, state->BufferLength*2);
+        state->SampleBuffer = temp;
+        state->BufferLength = maxlen;
+    }
+    for(i = 0;i < state->BufferLength*2;i++)
+        state->SampleBuffer[i] = 0.0f;
+
+    for(i = 0;i < MAXCHANNELS;i++)
+        state->Gain[i] = 0.0f;
+    for(i = 0;i < Device->NumChan;i++)
+    {
+        Channel chan = Device->Speaker2Chan[i];
+        state->Gain[chan] = 1.0f;
+    }
+
+    return AL_TRUE;
+}
+
+static ALvoid ChorusUpdate(ALeffectState *effect, ALCcontext *Context, const ALeffect *Effect)
+{
+    ALchorusState *state = (ALchorusState*)effect;
+    ALuint frequency = Context->Device->Frequency;
+
+    state->Waveform = Effect->Chorus.Waveform;
+    state->LfoStep = Effect->Chorus.Rate / frequency;
+    state->LfoOffset = WrapLfoPos(Effect->Chorus.Phase / 360.0f);
+
+    state->Delay = Effect->Chorus.Delay * frequency;
+    state->Depth = Effect->Chorus.Depth * state->Delay;
+    state->Feedback = Effect->Chorus.Feedback;
+}
+
+static ALvoid ChorusProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[MAXCHANNELS])
+{
+    ALchorusState *state = (ALchorusState*)effect;
+    const ALuint mask = state->BufferLength-1;
+    const ALfloat gain = Slot->Gain;
+    ALfloat gains[MAXCHANNELS];
+    ALfloat pos, d0, d1, samp[2];
+    ALuint base, todo, c, i;
+
+    for(i = 0;i < MAXCHANNELS;i++)
+        gains[i] = state->Gain[i] * gain;
+
+    for(base = 0;base < SamplesToDo;base += todo)
+    {
+        todo = __min(SamplesToDo-base, LFO_BLOCK_SIZE);
+
+        for(c = 0;c < 2;c++)
+        {
+            pos = state->LfoPos;
+            if(c == 1)
+                pos = WrapLfoPos(pos + state->LfoOffset);
+
+            d0 = state->Delay + state->Depth*LfoLevel(state->Waveform, pos);
+            pos = WrapLfoPos(pos + state->LfoStep*todo);
+            d1 = state->Delay + state->Depth*LfoLevel(state->Waveform, pos);
+            d0 = __max(d0, 1.0f);
+            d1 = __max(d1, 1.0f);
+
+            ModulatedDelay(&state->SampleBuffer[c*state->BufferLength], mask,
+                           state->Offset, d0, (d1-d0) / todo, state->Feedback,
+                           &SamplesIn[base], state->Buffer[c], todo);
+        }
+        state->LfoPos = WrapLfoPos(state->LfoPos + state->LfoStep*todo);
+        state->Offset += todo;
+
+        for(i = 0;i < todo;i++)
+        {
+            samp[0] = state->Buffer[0][i];
+            samp[1] = state->Buffer[1][i];
+
+            SamplesOut[base+i][FRONT_LEFT]  += gains[FRONT_LEFT]  * samp[0];
+            SamplesOut[base+i][FRONT_RIGHT] += gains[FRONT_RIGHT] * samp[1];
+            SamplesOut[base+i][SIDE_LEFT]   += gains[SIDE_LEFT]   * samp[0];
+            SamplesOut[base+i][SIDE_RIGHT]  += gains[SIDE_RIGHT]  * samp[1];
+            SamplesOut[base+i][BACK_LEFT]   += gains[BACK_LEFT]   * samp[0];
+            SamplesOut[base+i][BACK_RIGHT]  += gains[BACK_RIGHT]  * samp[1];
+        }
+    }
+}
+
+static ALeffectState *CreateModulatedDelay(ALfloat maxDelay)
+{
+    ALchorusState *state;
+
+    state = malloc(sizeof(*state));
+    if(!state)
+        return NULL;
+
+    state->state.Destroy = ChorusDestroy;
+    state->state.DeviceUpdate = ChorusDeviceUpdate;
+    state->state.Update = ChorusUpdate;
+    state->state.Process = ChorusProcess;
+
+    state->Device = NULL;
+    state->BufferLength = 0;
+    state->SampleBuffer = NULL;
+    state->Offset = 0;
+
+    state->MaxDelay = maxDelay;
+
+    state->Waveform = AL_CHORUS_WAVEFORM_TRIANGLE;
+    state->LfoPos = 0.0f;
+    state->LfoStep = 0.0f;
+    state->LfoOffset = 0.0f;
+
+    state->Delay = 1.0f;
+    state->Depth = 0.0f;
+    state->Feedback = 0.0f;
+
+    return &state->state;
+}
+
+ALeffectState *ChorusCreate(void)
+{
+    return CreateModulatedDelay(AL_CHORUS_MAX_DELAY);
+}
+
+ALeffectState *FlangerCreate(void)
+{
+    return CreateModulatedDelay(AL_FLANGER_MAX_DELAY);
+}
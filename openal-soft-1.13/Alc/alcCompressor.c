@@ -0,0 +1,320 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "alMain.h"
+#include "alFilter.h"
+#include "alAuxEffectSlot.h"
+#include "alError.h"
+#include "alu.h"
+
+
+// The maximum number of samples processed at once.
+#define MAX_UPDATE_SAMPLES 128
+
+/* The envelope is detected from the peak of each sub-block, rather than per
+ * sample. The signal is delayed by two sub-blocks, so the gain for a sub-block
+ * can ramp down to cover both it and the one after before either is output.
+ * Must be a power of 2.
+ */
+#define SUBBLOCK_SIZE 32
+
+// Time for the gain to recover most of the way after a peak.
+#define RELEASE_TIME  0.2f
+
+// The slot effect's threshold and ratio, and the master limiter's ceiling.
+#define COMPRESSOR_THRESHOLD 0.25f
+#define COMPRESSOR_RATIO     4.0f
+#define LIMITER_CEILING      1.0f
+
+typedef struct Compressor {
+    // Peak level above which the gain is reduced
+    ALfloat Threshold;
+    // Gain exponent for peaks over the threshold (1/ratio - 1), or -1 to
+    // limit
+    ALfloat Slope;
+    // Gain applied below the threshold
+    ALfloat Makeup;
+    // Fraction of the way the gain recovers each sub-block
+    ALfloat Release;
+
+    // Current gain, the ramp's per-sample step, and where it ends
+    ALfloat Gain;
+    ALfloat Step;
+    ALfloat Target;
+
+    // Peak levels of the two sub-blocks in the delay line
+    ALfloat Peak[2];
+    // Position in the delay line
+    ALuint Pos;
+} Compressor;
+
+typedef struct ALcompressorState {
+    // Must be first in all effects!
+    ALeffectState state;
+
+    ALfloat Gain[MAXCHANNELS];
+
+    Compressor Comp;
+    ALfloat Delay[SUBBLOCK_SIZE*2];
+
+    ALfloat Buffer[MAX_UPDATE_SAMPLES];
+} ALcompressorState;
+
+struct MasterLimiter {
+    Compressor Comp;
+    ALfloat Delay[SUBBLOCK_SIZE*2][MAXCHANNELS];
+};
+
+
+static __inline ALfloat CalcTargetGain(const Compressor *comp, ALfloat peak)
+{
+    if(peak <= comp->Threshold)
+        return comp->Makeup;
+    if(comp->Slope == -1.0f)
+        return comp->Makeup * comp->Threshold / peak;
+    return comp->Makeup * aluPow(peak/comp->Threshold, comp->Slope);
+}
+
+/* Sets up the gain ramp for the sub-block about to leave the delay line. The
+ * ramp starts and ends at or below the gain needed for this sub-block, so no
+ * sample in it overshoots.
+ */
+static ALvoid StartRamp(Compressor *comp)
+{
+    ALuint half = comp->Pos / SUBBLOCK_SIZE;
+    ALfloat target;
+
+    comp->Gain = comp->Target;
+    target = __min(CalcTargetGain(comp, comp->Peak[half]),
+                   CalcTargetGain(comp, comp->Peak[half^1]));
+    if(target > comp->Gain)
+        target = comp->Gain + (target-comp->Gain)*comp->Release;
+
+    comp->Target = target;
+    comp->Step = (target-comp->Gain) / SUBBLOCK_SIZE;
+    // This half gets refilled with new input as it's output
+    comp->Peak[half] = 0.0f;
+}
+
+static ALvoid SetCompressorParams(Compressor *comp, ALfloat threshold, ALfloat ratio, ALuint frequency)
+{
+    comp->Threshold = threshold;
+    if(ratio > 0.0f)
+        comp->Slope = 1.0f/ratio - 1.0f;
+    else
+        comp->Slope = -1.0f;
+    // Scale up quieter signals so a full-scale peak stays at full-scale
+    comp->Makeup = 1.0f;
+    comp->Makeup = 1.0f / CalcTargetGain(comp, 1.0f);
+    comp->Release = 1.0f - exp(-(ALfloat)SUBBLOCK_SIZE /
+                               (RELEASE_TIME*frequency));
+}
+
+static ALvoid ClearCompressor(Compressor *comp)
+{
+    comp->Gain = comp->Makeup;
+    comp->Step = 0.0f;
+    comp->Target = comp->Makeup;
+    comp->Peak[0] = 0.0f;
+    comp->Peak[1] = 0.0f;
+    comp->Pos = 0;
+}
+
+
+static ALvoid CompressorDestroy(ALeffectState *effect)
+{
+    ALcompressorState *state = (ALcompressorState*)effect;
+    free(state);
+}
+
+static ALboolean CompressorDeviceUpdate(ALeffectState *effect, ALCdevice *Device)
+{
+    ALcompressorState *state = (ALcompressorState*)effect;
+    ALuint index;
+
+    for(index = 0;index < MAXCHANNELS;index++)
+        state->Gain[index] = 0.0f;
+    for(index = 0;index < Device->NumChan;index++)
+    {
+        Channel chan = Device->Speaker2Chan[index];
+        state->Gain[chan] = 1.0f;
+    }
+
+    SetCompressorParams(&state->Comp, COMPRESSOR_THRESHOLD, COMPRESSOR_RATIO,
+                        Device->Frequency);
+    ClearCompressor(&state->Comp);
+    for(index = 0;index < SUBBLOCK_SIZE*2;index++)
+        state->Delay[index] = 0.0f;
+
+    return AL_TRUE;
+}
+
+static ALvoid CompressorUpdate(ALeffectState *effect, ALCcontext *Context, const ALeffect *Effect)
+{
+    ALcompressorState *state = (ALcompressorState*)effect;
+    ALuint frequency = Context->Device->Frequency;
+
+    /* When switched off, the gain ramps back to unity instead of jumping.
+     * The signal stays delayed either way, so it doesn't skip. */
+    if(Effect->Compressor.OnOff)
+        SetCompressorParams(&state->Comp, COMPRESSOR_THRESHOLD,
+                            COMPRESSOR_RATIO, frequency);
+    else
+        SetCompressorParams(&state->Comp, 1.0f, 1.0f, frequency);
+}
+
+static ALvoid CompressorProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[MAXCHANNELS])
+{
+    ALcompressorState *state = (ALcompressorState*)effect;
+    Compressor *comp = &state->Comp;
+    ALfloat *samps = state->Buffer;
+    const ALfloat gain = Slot->Gain;
+    ALfloat gains[MAXCHANNELS];
+    ALuint base, todo, count;
+    ALfloat g, step, peak, in;
+    ALuint i, pos;
+
+    for(i = 0;i < MAXCHANNELS;i++)
+        gains[i] = state->Gain[i] * gain;
+
+    for(base = 0;base < SamplesToDo;base += count)
+    {
+        todo = __min(SamplesToDo-base, MAX_UPDATE_SAMPLES);
+
+        for(count = 0;count < todo;)
+        {
+            ALuint n;
+
+            if((comp->Pos&(SUBBLOCK_SIZE-1)) == 0)
+                StartRamp(comp);
+            n = __min(todo-count, SUBBLOCK_SIZE - (comp->Pos&(SUBBLOCK_SIZE-1)));
+
+            g = comp->Gain;
+            step = comp->Step;
+            pos = comp->Pos;
+            peak = comp->Peak[pos/SUBBLOCK_SIZE];
+            for(i = 0;i < n;i++)
+            {
+                in = SamplesIn[base+count+i];
+                g += step;
+                samps[count+i] = state->Delay[pos+i] * g;
+                state->Delay[pos+i] = in;
+                peak = __max(peak, aluFabs(in));
+            }
+            comp->Gain = g;
+            comp->Peak[pos/SUBBLOCK_SIZE] = peak;
+            comp->Pos = (pos+n) & (SUBBLOCK_SIZE*2 - 1);
+
+            count += n;
+        }
+
+        for(i = 0;i < todo;i++)
+        {
+            ALfloat samp = samps[i];
+            SamplesOut[base+i][FRONT_LEFT]   += gains[FRONT_LEFT]   * samp;
+            SamplesOut[base+i][FRONT_RIGHT]  += gains[FRONT_RIGHT]  * samp;
+            SamplesOut[base+i][FRONT_CENTER] += gains[FRONT_CENTER] * samp;
+            SamplesOut[base+i][SIDE_LEFT]    += gains[SIDE_LEFT]    * samp;
+            SamplesOut[base+i][SIDE_RIGHT]   += gains[SIDE_RIGHT]   * samp;
+            SamplesOut[base+i][BACK_LEFT]    += gains[BACK_LEFT]    * samp;
+            SamplesOut[base+i][BACK_RIGHT]   += gains[BACK_RIGHT]   * samp;
+            SamplesOut[base+i][BACK_CENTER]  += gains[BACK_CENTER]  * samp;
+        }
+    }
+}
+
+ALeffectState *CompressorCreate(void)
+{
+    ALcompressorState *state;
+
+    state = malloc(sizeof(*state));
+    if(!state)
+        return NULL;
+
+    state->state.Destroy = CompressorDestroy;
+    state->state.DeviceUpdate = CompressorDeviceUpdate;
+    state->state.Update = CompressorUpdate;
+    state->state.Process = CompressorProcess;
+
+    return &state->state;
+}
+
+
+struct MasterLimiter *CreateMasterLimiter(void)
+{
+    return calloc(1, sizeof(struct MasterLimiter));
+}
+
+ALvoid ResetMasterLimiter(struct MasterLimiter *limiter, ALuint frequency)
+{
+    ALuint i, c;
+
+    // A limiter doesn't raise quieter signals, so there's no makeup gain
+    SetCompressorParams(&limiter->Comp, LIMITER_CEILING, 0.0f, frequency);
+    ClearCompressor(&limiter->Comp);
+    for(i = 0;i < SUBBLOCK_SIZE*2;i++)
+    {
+        for(c = 0;c < MAXCHANNELS;c++)
+            limiter->Delay[i][c] = 0.0f;
+    }
+}
+
+/* Keeps the peaks of the mix within full-scale, so the output conversion
+ * doesn't hard-clip. All channels share one gain to keep the image steady.
+ * Note this is applied before the channel matrix, so heavily downmixed
+ * output can still exceed full-scale.
+ */
+ALvoid ApplyMasterLimiter(struct MasterLimiter *limiter, ALfloat (*Buffer)[MAXCHANNELS], ALuint SamplesToDo)
+{
+    Compressor *comp = &limiter->Comp;
+    ALuint count, n, i, c, pos;
+    ALfloat g, step, peak, in;
+
+    for(count = 0;count < SamplesToDo;count += n)
+    {
+        if((comp->Pos&(SUBBLOCK_SIZE-1)) == 0)
+            StartRamp(comp);
+        n = __min(SamplesToDo-count, SUBBLOCK_SIZE - (comp->Pos&(SUBBLOCK_SIZE-1)));
+
+        g = comp->Gain;
+        step = comp->Step;
+        pos = comp->Pos;
+        peak = comp->Peak[pos/SUBBLOCK_SIZE];
+        for(i = 0;i < n;i++)
+        {
+            g += step;
+            for(c = 0;c < MAXCHANNELS;c++)
+            {
+                in = Buffer[count+i][c];
+                Buffer[count+i][c] = limiter->Delay[pos+i][c] * g;
+                limiter->Delay[pos+i][c] = in;
+                peak = __max(peak, aluFabs(in));
+            }
+        }
+        comp->Gain = g;
+        comp->Peak[pos/SUBBLOCK_SIZE] = peak;
+        comp->Pos = (pos+n) & (SUBBLOCK_SIZE*2 - 1);
+    }
+}
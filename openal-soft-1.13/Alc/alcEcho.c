@@ -22,6 +22,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "alMain.h"
 #include "alFilter.h"
@@ -30,10 +31,19 @@
 #include "alu.h"
 
 
+// The most samples processed at once. Blocks are also kept shorter than the
+// first tap's delay, so no tap reads what the same block writes.
+#define ECHO_BLOCK_SIZE 128
+// First taps shorter than this are done a sample at a time, since blocks
+// that short cost more in copies than they save
+#define ECHO_MIN_BLOCK  16
+
 typedef struct ALechoState {
     // Must be first in all effects!
     ALeffectState state;
 
+    // Allocated from the device's effect memory
+    ALCdevice *Device;
     ALfloat *SampleBuffer;
     ALuint BufferLength;
 
@@ -49,18 +59,50 @@ typedef struct ALechoState {
 
     ALfloat FeedGain;
 
-    ALfloat Gain[MAXCHANNELS];
+    // The device's output channels taking the left and right signals
+    Channel LeftChans[MAXCHANNELS];
+    Channel RightChans[MAXCHANNELS];
+    ALuint NumLeftChans;
+    ALuint NumRightChans;
 
     FILTER iirFilter;
     ALfloat history[2];
+
+    ALfloat TapBuffer[2][ECHO_BLOCK_SIZE];
+    ALfloat Buffer[2][ECHO_BLOCK_SIZE];
 } ALechoState;
 
+
+/* Copies a run of samples out of the delay line, splitting it where the line
+ * wraps so each part is contiguous. */
+static __inline ALvoid ReadDelayLine(const ALfloat *line, ALuint length, ALuint pos, ALfloat *out, ALuint todo)
+{
+    ALuint todo1;
+
+    pos &= length-1;
+    todo1 = __min(todo, length-pos);
+    memcpy(out, &line[pos], todo1*sizeof(ALfloat));
+    memcpy(&out[todo1], line, (todo-todo1)*sizeof(ALfloat));
+}
+
+static __inline ALvoid WriteDelayLine(ALfloat *line, ALuint length, ALuint pos, const ALfloat *in, ALuint todo)
+{
+    ALuint todo1;
+
+    pos &= length-1;
+    todo1 = __min(todo, length-pos);
+    memcpy(&line[pos], in, todo1*sizeof(ALfloat));
+    memcpy(line, &in[todo1], (todo-todo1)*sizeof(ALfloat));
+}
+
 static ALvoid EchoDestroy(ALeffectState *effect)
 {
     ALechoState *state = (ALechoState*)effect;
     if(state)
     {
-        free(state->SampleBuffer);
+        if(state->Device)
+            FreeEffectSamples(state->Device, state->SampleBuffer,
+                              state->BufferLength);
         state->SampleBuffer = NULL;
         free(state);
     }
@@ -77,25 +119,31 @@ static ALboolean EchoDeviceUpdate(ALeffectState *effect, ALCdevice *Device)
     maxlen += (ALuint)(AL_ECHO_MAX_LRDELAY * Device->Frequency) + 1;
     maxlen  = NextPowerOf2(maxlen);
 
+    state->Device = Device;
     if(maxlen != state->BufferLength)
     {
-        void *temp;
+        ALfloat *temp;
 
-        temp = realloc(state->SampleBuffer, maxlen * sizeof(ALfloat));
+        temp = AllocEffectSamples(Device, maxlen);
         if(!temp)
             return AL_FALSE;
+        FreeEffectSamples(Device, state->SampleBuffer, state->BufferLength);
         state->SampleBuffer = temp;
         state->BufferLength = maxlen;
     }
     for(i = 0;i < state->BufferLength;i++)
         state->SampleBuffer[i] = 0.0f;
 
-    for(i = 0;i < MAXCHANNELS;i++)
-        state->Gain[i] = 0.0f;
+    // Only the front, side and back pairs get the echo
+    state->NumLeftChans = 0;
+    state->NumRightChans = 0;
     for(i = 0;i < Device->NumChan;i++)
     {
         Channel chan = Device->Speaker2Chan[i];
-        state->Gain[chan] = 1.0f;
+        if(chan == FRONT_LEFT || chan == SIDE_LEFT || chan == BACK_LEFT)
+            state->LeftChans[state->NumLeftChans++] = chan;
+        else if(chan == FRONT_RIGHT || chan == SIDE_RIGHT || chan == BACK_RIGHT)
+            state->RightChans[state->NumRightChans++] = chan;
     }
 
     return AL_TRUE;
@@ -128,41 +176,103 @@ static ALvoid EchoUpdate(ALeffectState *effect, ALCcontext *Context, const ALeff
 static ALvoid EchoProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[MAXCHANNELS])
 {
     ALechoState *state = (ALechoState*)effect;
-    const ALuint mask = state->BufferLength-1;
+    const ALuint length = state->BufferLength;
     const ALuint tap1 = state->Tap[0].delay;
     const ALuint tap2 = state->Tap[1].delay;
+    ALfloat *tap1Buf = state->TapBuffer[0];
+    ALfloat *tap2Buf = state->TapBuffer[1];
+    ALfloat *left = state->Buffer[0];
+    ALfloat *right = state->Buffer[1];
     ALuint offset = state->Offset;
     const ALfloat gain = Slot->Gain;
-    ALfloat samp[2], smp;
-    ALuint i;
+    const ALfloat feedGain = state->FeedGain;
+    // The damping filter's state is kept local for the whole update, so it
+    // isn't reloaded for every sample. Each pole is written as x*(1-a) + y*a,
+    // so only one multiply-add depends on the previous output
+    const ALfloat a = state->iirFilter.coeff;
+    const ALfloat b = 1.0f - a;
+    ALfloat hist0 = state->iirFilter.history[0];
+    ALfloat hist1 = state->iirFilter.history[1];
+    const Channel *leftChans = state->LeftChans;
+    const Channel *rightChans = state->RightChans;
+    const ALuint numLeft = state->NumLeftChans;
+    const ALuint numRight = state->NumRightChans;
+    ALfloat gainL, gainR;
+    ALuint base, todo, i, c;
+
+    // Apply slot gain
+    gainL = state->GainL * gain;
+    gainR = state->GainR * gain;
+
+    if(tap1 < ECHO_MIN_BLOCK)
+    {
+        const ALuint mask = length-1;
+        ALfloat smp, l, r;
+
+        for(i = 0;i < SamplesToDo;i++,offset++)
+        {
+            // Sample first tap
+            smp = state->SampleBuffer[(offset-tap1) & mask];
+            l = smp * gainL;
+            r = smp * gainR;
+            // Sample second tap. Reverse LR panning
+            smp = state->SampleBuffer[(offset-tap2) & mask];
+            l += smp * gainR;
+            r += smp * gainL;
+
+            smp += SamplesIn[i];
+            hist0 = smp*b + hist0*a;
+            hist1 = hist0*b + hist1*a;
+            state->SampleBuffer[offset&mask] = hist1 * feedGain;
+
+            for(c = 0;c < numLeft;c++)
+                SamplesOut[i][leftChans[c]] += l;
+            for(c = 0;c < numRight;c++)
+                SamplesOut[i][rightChans[c]] += r;
+        }
+        state->iirFilter.history[0] = hist0;
+        state->iirFilter.history[1] = hist1;
+        state->Offset = offset;
+        return;
+    }
 
-    for(i = 0;i < SamplesToDo;i++,offset++)
+    for(base = 0;base < SamplesToDo;base += todo)
     {
-        // Sample first tap
-        smp = state->SampleBuffer[(offset-tap1) & mask];
-        samp[0] = smp * state->GainL;
-        samp[1] = smp * state->GainR;
-        // Sample second tap. Reverse LR panning
-        smp = state->SampleBuffer[(offset-tap2) & mask];
-        samp[0] += smp * state->GainR;
-        samp[1] += smp * state->GainL;
+        todo = __min(SamplesToDo-base, ECHO_BLOCK_SIZE);
+        todo = __min(todo, tap1);
+
+        ReadDelayLine(state->SampleBuffer, length, offset-tap1, tap1Buf, todo);
+        ReadDelayLine(state->SampleBuffer, length, offset-tap2, tap2Buf, todo);
+
+        // Mix the taps, with the second tap's LR panning reversed
+        for(i = 0;i < todo;i++)
+        {
+            left[i]  = tap1Buf[i]*gainL + tap2Buf[i]*gainR;
+            right[i] = tap1Buf[i]*gainR + tap2Buf[i]*gainL;
+        }
 
         // Apply damping and feedback gain to the second tap, and mix in the
-        // new sample
-        smp = lpFilter2P(&state->iirFilter, 0, smp+SamplesIn[i]);
-        state->SampleBuffer[offset&mask] = smp * state->FeedGain;
-
-        // Apply slot gain
-        samp[0] *= gain;
-        samp[1] *= gain;
-
-        SamplesOut[i][FRONT_LEFT]  += state->Gain[FRONT_LEFT]  * samp[0];
-        SamplesOut[i][FRONT_RIGHT] += state->Gain[FRONT_RIGHT] * samp[1];
-        SamplesOut[i][SIDE_LEFT]   += state->Gain[SIDE_LEFT]   * samp[0];
-        SamplesOut[i][SIDE_RIGHT]  += state->Gain[SIDE_RIGHT]  * samp[1];
-        SamplesOut[i][BACK_LEFT]   += state->Gain[BACK_LEFT]   * samp[0];
-        SamplesOut[i][BACK_RIGHT]  += state->Gain[BACK_RIGHT]  * samp[1];
+        // new samples
+        for(i = 0;i < todo;i++)
+        {
+            ALfloat smp = tap2Buf[i] + SamplesIn[base+i];
+            hist0 = smp*b + hist0*a;
+            hist1 = hist0*b + hist1*a;
+            tap2Buf[i] = hist1 * feedGain;
+        }
+        WriteDelayLine(state->SampleBuffer, length, offset, tap2Buf, todo);
+        offset += todo;
+
+        for(i = 0;i < todo;i++)
+        {
+            for(c = 0;c < numLeft;c++)
+                SamplesOut[base+i][leftChans[c]] += left[i];
+            for(c = 0;c < numRight;c++)
+                SamplesOut[base+i][rightChans[c]] += right[i];
+        }
     }
+    state->iirFilter.history[0] = hist0;
+    state->iirFilter.history[1] = hist1;
     state->Offset = offset;
 }
 
@@ -179,14 +289,18 @@ ALeffectState *EchoCreate(void)
     state->state.Update = EchoUpdate;
     state->state.Process = EchoProcess;
 
+    state->Device = NULL;
     state->BufferLength = 0;
     state->SampleBuffer = NULL;
 
-    state->Tap[0].delay = 0;
-    state->Tap[1].delay = 0;
+    // The process loop's blocks can't be longer than the first tap's delay
+    state->Tap[0].delay = 1;
+    state->Tap[1].delay = 1;
     state->Offset = 0;
     state->GainL = 0.0f;
     state->GainR = 0.0f;
+    state->NumLeftChans = 0;
+    state->NumRightChans = 0;
 
     state->iirFilter.coeff = 0.0f;
     state->iirFilter.history[0] = 0.0f;
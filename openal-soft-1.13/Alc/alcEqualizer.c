@@ -0,0 +1,319 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <stdlib.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON
+#endif
+
+#include "alMain.h"
+#include "alFilter.h"
+#include "alAuxEffectSlot.h"
+#include "alError.h"
+#include "alu.h"
+
+
+// The maximum number of samples filtered at once.
+#define MAX_UPDATE_SAMPLES 128
+
+/* The equalizer is a cascade of four biquads (low shelf, two peaking mids,
+ * and high shelf) in transposed direct form II.  To run all four bands in
+ * one vector, the cascade is skewed by a sample per band: while band 0
+ * filters input sample n, band 1 filters band 0's output for sample n-1, and
+ * so on.  This delays the output by three samples.
+ */
+typedef struct ALequalizerState {
+    // Must be first in all effects!
+    ALeffectState state;
+
+    ALfloat Gain[MAXCHANNELS];
+
+    // Per-band coefficients (normalized so a0 is 1) and history
+    ALfloat b0[4], b1[4], b2[4];
+    ALfloat a1[4], a2[4];
+    ALfloat z1[4], z2[4];
+    // Each band's last output, feeding the next band
+    ALfloat y[4];
+
+    ALfloat Buffer[MAX_UPDATE_SAMPLES];
+} ALequalizerState;
+
+enum {
+    LOW_SHELF = 0,
+    PEAKING_MID1,
+    PEAKING_MID2,
+    HIGH_SHELF
+};
+
+
+// Calculates a band's biquad coefficients, from the RBJ audio EQ cookbook.
+static ALvoid CalcBandCoeffs(ALequalizerState *state, ALuint band, ALfloat gain, ALfloat freq, ALfloat width, ALuint frequency)
+{
+    ALfloat w0, cw, alpha, A, sqrtA;
+    ALfloat b[3], a[3];
+
+    // Keep the band below nyquist, for low playback rates
+    freq = __min(freq, frequency*0.49f);
+    w0 = 2.0f*M_PI * freq / frequency;
+    cw = cos(w0);
+    // The gains are amplitudes, and the shelves and peaks use their root
+    A = aluSqrt(gain);
+
+    switch(band)
+    {
+    case LOW_SHELF:
+        sqrtA = aluSqrt(A);
+        alpha = sin(w0) / aluSqrt(2.0f);
+        b[0] =        A*((A+1.0f) - (A-1.0f)*cw + 2.0f*sqrtA*alpha);
+        b[1] =  2.0f* A*((A-1.0f) - (A+1.0f)*cw);
+        b[2] =        A*((A+1.0f) - (A-1.0f)*cw - 2.0f*sqrtA*alpha);
+        a[0] =           (A+1.0f) + (A-1.0f)*cw + 2.0f*sqrtA*alpha;
+        a[1] = -2.0f*   ((A-1.0f) + (A+1.0f)*cw);
+        a[2] =           (A+1.0f) + (A-1.0f)*cw - 2.0f*sqrtA*alpha;
+        break;
+
+    case HIGH_SHELF:
+        sqrtA = aluSqrt(A);
+        alpha = sin(w0) / aluSqrt(2.0f);
+        b[0] =        A*((A+1.0f) + (A-1.0f)*cw + 2.0f*sqrtA*alpha);
+        b[1] = -2.0f* A*((A-1.0f) + (A+1.0f)*cw);
+        b[2] =        A*((A+1.0f) + (A-1.0f)*cw - 2.0f*sqrtA*alpha);
+        a[0] =           (A+1.0f) - (A-1.0f)*cw + 2.0f*sqrtA*alpha;
+        a[1] =  2.0f*   ((A-1.0f) - (A+1.0f)*cw);
+        a[2] =           (A+1.0f) - (A-1.0f)*cw - 2.0f*sqrtA*alpha;
+        break;
+
+    default:
+        // The width is the bandwidth in octaves
+        alpha = sin(w0) * sinh(log(2.0)/2.0 * width * w0/sin(w0));
+        b[0] =  1.0f + alpha*A;
+        b[1] = -2.0f * cw;
+        b[2] =  1.0f - alpha*A;
+        a[0] =  1.0f + alpha/A;
+        a[1] = -2.0f * cw;
+        a[2] =  1.0f - alpha/A;
+        break;
+    }
+
+    state->b0[band] = b[0] / a[0];
+    state->b1[band] = b[1] / a[0];
+    state->b2[band] = b[2] / a[0];
+    state->a1[band] = a[1] / a[0];
+    state->a2[band] = a[2] / a[0];
+}
+
+
+static ALvoid EqualizerDestroy(ALeffectState *effect)
+{
+    ALequalizerState *state = (ALequalizerState*)effect;
+    free(state);
+}
+
+static ALboolean EqualizerDeviceUpdate(ALeffectState *effect, ALCdevice *Device)
+{
+    ALequalizerState *state = (ALequalizerState*)effect;
+    ALuint index;
+
+    for(index = 0;index < MAXCHANNELS;index++)
+        state->Gain[index] = 0.0f;
+    for(index = 0;index < Device->NumChan;index++)
+    {
+        Channel chan = Device->Speaker2Chan[index];
+        state->Gain[chan] = 1.0f;
+    }
+
+    return AL_TRUE;
+}
+
+static ALvoid EqualizerUpdate(ALeffectState *effect, ALCcontext *Context, const ALeffect *Effect)
+{
+    ALequalizerState *state = (ALequalizerState*)effect;
+    ALuint frequency = Context->Device->Frequency;
+
+    CalcBandCoeffs(state, LOW_SHELF, Effect->Equalizer.LowGain,
+                   Effect->Equalizer.LowCutoff, 0.0f, frequency);
+    CalcBandCoeffs(state, PEAKING_MID1, Effect->Equalizer.Mid1Gain,
+                   Effect->Equalizer.Mid1Center, Effect->Equalizer.Mid1Width,
+                   frequency);
+    CalcBandCoeffs(state, PEAKING_MID2, Effect->Equalizer.Mid2Gain,
+                   Effect->Equalizer.Mid2Center, Effect->Equalizer.Mid2Width,
+                   frequency);
+    CalcBandCoeffs(state, HIGH_SHELF, Effect->Equalizer.HighGain,
+                   Effect->Equalizer.HighCutoff, 0.0f, frequency);
+}
+
+// Runs todo samples through the skewed band cascade.
+static ALvoid EqualizerFilter(ALequalizerState *state, const ALfloat *in, ALfloat *out, ALuint todo)
+{
+    ALuint i;
+
+#if defined(USE_SSE2)
+    const __m128 b0 = _mm_loadu_ps(state->b0);
+    const __m128 b1 = _mm_loadu_ps(state->b1);
+    const __m128 b2 = _mm_loadu_ps(state->b2);
+    const __m128 a1 = _mm_loadu_ps(state->a1);
+    const __m128 a2 = _mm_loadu_ps(state->a2);
+    __m128 z1 = _mm_loadu_ps(state->z1);
+    __m128 z2 = _mm_loadu_ps(state->z2);
+    __m128 y = _mm_loadu_ps(state->y);
+    __m128 x;
+
+    for(i = 0;i < todo;i++)
+    {
+        // Shift each band's output up to the next band, and bring in the
+        // new input sample for the first
+        x = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y), 4));
+        x = _mm_move_ss(x, _mm_load_ss(&in[i]));
+
+        y  = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+        z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+        z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+
+        _mm_store_ss(&out[i], _mm_shuffle_ps(y, y, _MM_SHUFFLE(3,3,3,3)));
+    }
+
+    _mm_storeu_ps(state->z1, z1);
+    _mm_storeu_ps(state->z2, z2);
+    _mm_storeu_ps(state->y, y);
+#elif defined(USE_NEON)
+    const float32x4_t b0 = vld1q_f32(state->b0);
+    const float32x4_t b1 = vld1q_f32(state->b1);
+    const float32x4_t b2 = vld1q_f32(state->b2);
+    const float32x4_t a1 = vld1q_f32(state->a1);
+    const float32x4_t a2 = vld1q_f32(state->a2);
+    float32x4_t z1 = vld1q_f32(state->z1);
+    float32x4_t z2 = vld1q_f32(state->z2);
+    float32x4_t y = vld1q_f32(state->y);
+    float32x4_t x;
+
+    for(i = 0;i < todo;i++)
+    {
+        x = vextq_f32(vdupq_n_f32(in[i]), y, 3);
+
+        y  = vaddq_f32(vmulq_f32(b0, x), z1);
+        z1 = vaddq_f32(vsubq_f32(vmulq_f32(b1, x), vmulq_f32(a1, y)), z2);
+        z2 = vsubq_f32(vmulq_f32(b2, x), vmulq_f32(a2, y));
+
+        out[i] = vgetq_lane_f32(y, 3);
+    }
+
+    vst1q_f32(state->z1, z1);
+    vst1q_f32(state->z2, z2);
+    vst1q_f32(state->y, y);
+#else
+    ALfloat x[4], y[4];
+    ALuint band;
+
+    for(band = 0;band < 4;band++)
+        y[band] = state->y[band];
+
+    for(i = 0;i < todo;i++)
+    {
+        x[0] = in[i];
+        x[1] = y[0];
+        x[2] = y[1];
+        x[3] = y[2];
+
+        for(band = 0;band < 4;band++)
+        {
+            y[band] = state->b0[band]*x[band] + state->z1[band];
+            state->z1[band] = state->b1[band]*x[band] - state->a1[band]*y[band] +
+                              state->z2[band];
+            state->z2[band] = state->b2[band]*x[band] - state->a2[band]*y[band];
+        }
+
+        out[i] = y[3];
+    }
+
+    for(band = 0;band < 4;band++)
+        state->y[band] = y[band];
+#endif
+}
+
+static ALvoid EqualizerProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[MAXCHANNELS])
+{
+    ALequalizerState *state = (ALequalizerState*)effect;
+    ALfloat *samps = state->Buffer;
+    const ALfloat gain = Slot->Gain;
+    ALfloat gains[MAXCHANNELS];
+    ALuint base, todo;
+    ALfloat samp;
+    ALuint i;
+
+    for(i = 0;i < MAXCHANNELS;i++)
+        gains[i] = state->Gain[i] * gain;
+
+    for(base = 0;base < SamplesToDo;base += todo)
+    {
+        todo = __min(SamplesToDo-base, MAX_UPDATE_SAMPLES);
+
+        EqualizerFilter(state, &SamplesIn[base], samps, todo);
+
+        for(i = 0;i < todo;i++)
+        {
+            samp = samps[i];
+            SamplesOut[base+i][FRONT_LEFT]   += gains[FRONT_LEFT]   * samp;
+            SamplesOut[base+i][FRONT_RIGHT]  += gains[FRONT_RIGHT]  * samp;
+            SamplesOut[base+i][FRONT_CENTER] += gains[FRONT_CENTER] * samp;
+            SamplesOut[base+i][SIDE_LEFT]    += gains[SIDE_LEFT]    * samp;
+            SamplesOut[base+i][SIDE_RIGHT]   += gains[SIDE_RIGHT]   * samp;
+            SamplesOut[base+i][BACK_LEFT]    += gains[BACK_LEFT]    * samp;
+            SamplesOut[base+i][BACK_RIGHT]   += gains[BACK_RIGHT]   * samp;
+            SamplesOut[base+i][BACK_CENTER]  += gains[BACK_CENTER]  * samp;
+        }
+    }
+}
+
+ALeffectState *EqualizerCreate(void)
+{
+    ALequalizerState *state;
+    ALuint band;
+
+    state = malloc(sizeof(*state));
+    if(!state)
+        return NULL;
+
+    state->state.Destroy = EqualizerDestroy;
+    state->state.DeviceUpdate = EqualizerDeviceUpdate;
+    state->state.Update = EqualizerUpdate;
+    state->state.Process = EqualizerProcess;
+
+    for(band = 0;band < 4;band++)
+    {
+        // Pass-through until updated
+        state->b0[band] = 1.0f;
+        state->b1[band] = 0.0f;
+        state->b2[band] = 0.0f;
+        state->a1[band] = 0.0f;
+        state->a2[band] = 0.0f;
+        state->z1[band] = 0.0f;
+        state->z2[band] = 0.0f;
+        state->y[band] = 0.0f;
+    }
+
+    return &state->state;
+}
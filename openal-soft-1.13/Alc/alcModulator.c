@@ -22,6 +22,13 @@
 
 #include <math.h>
 #include <stdlib.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON
+#endif
 
 #include "alMain.h"
 #include "alFilter.h"
@@ -30,6 +37,9 @@
 #include "alu.h"
 
 
+// The maximum number of samples modulated and filtered at once.
+#define MAX_UPDATE_SAMPLES 128
+
 typedef struct ALmodulatorState {
     // Must be first in all effects!
     ALeffectState state;
@@ -47,14 +57,39 @@ typedef struct ALmodulatorState {
 
     FILTER iirFilter;
     ALfloat history[1];
+
+    ALfloat Buffer[MAX_UPDATE_SAMPLES];
 } ALmodulatorState;
 
 #define WAVEFORM_FRACBITS  16
 #define WAVEFORM_FRACMASK  ((1<<WAVEFORM_FRACBITS)-1)
 
+/* One period of a sine wave, with the first sample repeated at the end so
+ * interpolation never has to wrap. 1024 points with linear interpolation
+ * keeps the error below -100dB. */
+#define SINTABLE_BITS      10
+#define SINTABLE_SIZE      (1<<SINTABLE_BITS)
+#define SINTABLE_FRACBITS  (WAVEFORM_FRACBITS-SINTABLE_BITS)
+#define SINTABLE_FRACMASK  ((1<<SINTABLE_FRACBITS)-1)
+
+static ALfloat SinTable[SINTABLE_SIZE+1];
+
+/* Built once by alc_init, before any thread can create a modulator */
+ALvoid ModulatorInitTables(void)
+{
+    ALuint i;
+
+    for(i = 0;i < SINTABLE_SIZE;i++)
+        SinTable[i] = sin(i / (double)SINTABLE_SIZE * M_PI * 2.0);
+    SinTable[SINTABLE_SIZE] = SinTable[0];
+}
+
 static __inline ALfloat sin_func(ALuint index)
 {
-    return sin(index / (double)(1<<WAVEFORM_FRACBITS) * M_PI * 2.0f);
+    ALuint pos = index >> SINTABLE_FRACBITS;
+    ALfloat frac = (index&SINTABLE_FRACMASK) * (1.0f/(1<<SINTABLE_FRACBITS));
+
+    return SinTable[pos] + (SinTable[pos+1]-SinTable[pos])*frac;
 }
 
 static __inline ALfloat saw_func(ALuint index)
@@ -68,16 +103,113 @@ static __inline ALfloat square_func(ALuint index)
 }
 
 
-static __inline ALfloat hpFilter1P(FILTER *iir, ALuint offset, ALfloat input)
+/* Each of these multiplies todo input samples by the waveform, starting one
+ * step past index. */
+static ALvoid ModulateSin(ALfloat *out, const ALfloat *in, ALuint index, ALuint step, ALuint todo)
 {
-    ALfloat *history = &iir->history[offset];
-    ALfloat a = iir->coeff;
-    ALfloat output = input;
+    ALuint i;
 
-    output = output + (history[0]-output)*a;
-    history[0] = output;
+    for(i = 0;i < todo;i++)
+    {
+        index = (index+step) & WAVEFORM_FRACMASK;
+        out[i] = in[i] * sin_func(index);
+    }
+}
+
+static ALvoid ModulateSaw(ALfloat *out, const ALfloat *in, ALuint index, ALuint step, ALuint todo)
+{
+    ALuint i = 0;
 
-    return input - output;
+#if defined(USE_SSE2)
+    {
+        const __m128i mask = _mm_set1_epi32(WAVEFORM_FRACMASK);
+        const __m128i step4 = _mm_set1_epi32(step*4);
+        const __m128 scale = _mm_set1_ps(2.0f/(1<<WAVEFORM_FRACBITS));
+        const __m128 one = _mm_set1_ps(1.0f);
+        __m128i idx = _mm_setr_epi32(index+step, index+step*2,
+                                     index+step*3, index+step*4);
+        __m128 wave;
+
+        for(;i+4 <= todo;i += 4)
+        {
+            wave = _mm_cvtepi32_ps(_mm_and_si128(idx, mask));
+            wave = _mm_sub_ps(_mm_mul_ps(wave, scale), one);
+            _mm_storeu_ps(&out[i], _mm_mul_ps(_mm_loadu_ps(&in[i]), wave));
+            idx = _mm_add_epi32(idx, step4);
+        }
+    }
+#elif defined(USE_NEON)
+    {
+        const uint32x4_t mask = vdupq_n_u32(WAVEFORM_FRACMASK);
+        const uint32x4_t step4 = vdupq_n_u32(step*4);
+        const float32x4_t scale = vdupq_n_f32(2.0f/(1<<WAVEFORM_FRACBITS));
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const ALuint init[4] = { 1, 2, 3, 4 };
+        uint32x4_t idx = vmlaq_n_u32(vdupq_n_u32(index), vld1q_u32(init), step);
+        float32x4_t wave;
+
+        for(;i+4 <= todo;i += 4)
+        {
+            wave = vcvtq_f32_u32(vandq_u32(idx, mask));
+            wave = vsubq_f32(vmulq_f32(wave, scale), one);
+            vst1q_f32(&out[i], vmulq_f32(vld1q_f32(&in[i]), wave));
+            idx = vaddq_u32(idx, step4);
+        }
+    }
+#endif
+    index = (index + step*i) & WAVEFORM_FRACMASK;
+    for(;i < todo;i++)
+    {
+        index = (index+step) & WAVEFORM_FRACMASK;
+        out[i] = in[i] * saw_func(index);
+    }
+}
+
+static ALvoid ModulateSquare(ALfloat *out, const ALfloat *in, ALuint index, ALuint step, ALuint todo)
+{
+    ALuint i = 0;
+
+    /* Multiplying by +/-1 only flips the sign, so move the waveform's top
+     * bit up to the float sign bit and xor it in. */
+#if defined(USE_SSE2)
+    {
+        const __m128i step4 = _mm_set1_epi32(step*4);
+        const __m128i sign = _mm_set1_epi32(0x80000000);
+        __m128i idx = _mm_setr_epi32(index+step, index+step*2,
+                                     index+step*3, index+step*4);
+        __m128i flip;
+
+        for(;i+4 <= todo;i += 4)
+        {
+            flip = _mm_and_si128(_mm_slli_epi32(idx, 32-WAVEFORM_FRACBITS), sign);
+            _mm_storeu_ps(&out[i], _mm_xor_ps(_mm_loadu_ps(&in[i]),
+                                              _mm_castsi128_ps(flip)));
+            idx = _mm_add_epi32(idx, step4);
+        }
+    }
+#elif defined(USE_NEON)
+    {
+        const uint32x4_t step4 = vdupq_n_u32(step*4);
+        const uint32x4_t sign = vdupq_n_u32(0x80000000);
+        const ALuint init[4] = { 1, 2, 3, 4 };
+        uint32x4_t idx = vmlaq_n_u32(vdupq_n_u32(index), vld1q_u32(init), step);
+        uint32x4_t flip;
+
+        for(;i+4 <= todo;i += 4)
+        {
+            flip = vandq_u32(vshlq_n_u32(idx, 32-WAVEFORM_FRACBITS), sign);
+            vst1q_f32(&out[i], vreinterpretq_f32_u32(
+                veorq_u32(vreinterpretq_u32_f32(vld1q_f32(&in[i])), flip)));
+            idx = vaddq_u32(idx, step4);
+        }
+    }
+#endif
+    index = (index + step*i) & WAVEFORM_FRACMASK;
+    for(;i < todo;i++)
+    {
+        index = (index+step) & WAVEFORM_FRACMASK;
+        out[i] = in[i] * square_func(index);
+    }
 }
 
 
@@ -128,57 +260,62 @@ static ALvoid ModulatorUpdate(ALeffectState *effect, ALCcontext *Context, const
 static ALvoid ModulatorProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[MAXCHANNELS])
 {
     ALmodulatorState *state = (ALmodulatorState*)effect;
+    ALfloat *samps = state->Buffer;
     const ALfloat gain = Slot->Gain;
     const ALuint step = state->step;
+    const ALfloat a = state->iirFilter.coeff;
+    ALfloat history = state->iirFilter.history[0];
+    ALfloat gains[MAXCHANNELS];
     ALuint index = state->index;
-    ALfloat samp;
+    ALuint base, todo;
+    ALfloat samp, output;
     ALuint i;
 
-    switch(state->Waveform)
+    for(i = 0;i < MAXCHANNELS;i++)
+        gains[i] = state->Gain[i];
+
+    for(base = 0;base < SamplesToDo;base += todo)
     {
-    case SINUSOID:
-        for(i = 0;i < SamplesToDo;i++)
+        todo = __min(SamplesToDo-base, MAX_UPDATE_SAMPLES);
+
+        switch(state->Waveform)
         {
-#define FILTER_OUT(func) do {                                                 \
-    samp = SamplesIn[i];                                                      \
-                                                                              \
-    index += step;                                                            \
-    index &= WAVEFORM_FRACMASK;                                               \
-    samp *= func(index);                                                      \
-                                                                              \
-    samp = hpFilter1P(&state->iirFilter, 0, samp);                            \
-                                                                              \
-    /* Apply slot gain */                                                     \
-    samp *= gain;                                                             \
-                                                                              \
-    SamplesOut[i][FRONT_LEFT]   += state->Gain[FRONT_LEFT]   * samp;          \
-    SamplesOut[i][FRONT_RIGHT]  += state->Gain[FRONT_RIGHT]  * samp;          \
-    SamplesOut[i][FRONT_CENTER] += state->Gain[FRONT_CENTER] * samp;          \
-    SamplesOut[i][SIDE_LEFT]    += state->Gain[SIDE_LEFT]    * samp;          \
-    SamplesOut[i][SIDE_RIGHT]   += state->Gain[SIDE_RIGHT]   * samp;          \
-    SamplesOut[i][BACK_LEFT]    += state->Gain[BACK_LEFT]    * samp;          \
-    SamplesOut[i][BACK_RIGHT]   += state->Gain[BACK_RIGHT]   * samp;          \
-    SamplesOut[i][BACK_CENTER]  += state->Gain[BACK_CENTER]  * samp;          \
-} while(0)
-            FILTER_OUT(sin_func);
+        case SINUSOID:
+            ModulateSin(samps, &SamplesIn[base], index, step, todo);
+            break;
+        case SAWTOOTH:
+            ModulateSaw(samps, &SamplesIn[base], index, step, todo);
+            break;
+        case SQUARE:
+            ModulateSquare(samps, &SamplesIn[base], index, step, todo);
+            break;
         }
-        break;
+        index = (index + step*todo) & WAVEFORM_FRACMASK;
 
-    case SAWTOOTH:
-        for(i = 0;i < SamplesToDo;i++)
+        for(i = 0;i < todo;i++)
         {
-            FILTER_OUT(saw_func);
+            /* High-pass filter, then apply slot gain */
+            samp = samps[i];
+            output = samp + (history-samp)*a;
+            history = output;
+            samps[i] = (samp - output) * gain;
         }
-        break;
 
-    case SQUARE:
-        for(i = 0;i < SamplesToDo;i++)
+        for(i = 0;i < todo;i++)
         {
-            FILTER_OUT(square_func);
-#undef FILTER_OUT
+            samp = samps[i];
+            SamplesOut[base+i][FRONT_LEFT]   += gains[FRONT_LEFT]   * samp;
+            SamplesOut[base+i][FRONT_RIGHT]  += gains[FRONT_RIGHT]  * samp;
+            SamplesOut[base+i][FRONT_CENTER] += gains[FRONT_CENTER] * samp;
+            SamplesOut[base+i][SIDE_LEFT]    += gains[SIDE_LEFT]    * samp;
+            SamplesOut[base+i][SIDE_RIGHT]   += gains[SIDE_RIGHT]   * samp;
+            SamplesOut[base+i][BACK_LEFT]    += gains[BACK_LEFT]    * samp;
+            SamplesOut[base+i][BACK_RIGHT]   += gains[BACK_RIGHT]   * samp;
+            SamplesOut[base+i][BACK_CENTER]  += gains[BACK_CENTER]  * samp;
         }
-        break;
     }
+
+    state->iirFilter.history[0] = history;
     state->index = index;
 }
 
@@ -23,6 +23,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON
+#endif
 
 #include "AL/al.h"
 #include "AL/alc.h"
@@ -32,6 +39,9 @@
 #include "alError.h"
 #include "alu.h"
 
+// The maximum number of samples processed through the lines at once.
+#define MAX_UPDATE_SAMPLES 128
+
 typedef struct DelayLine
 {
     // The delay lines use sample lengths that are powers of 2 to allow the
@@ -40,14 +50,29 @@ typedef struct DelayLine
     ALfloat *Line;
 } DelayLine;
 
+// The parameters that determine the lengths of the variable delay lines:
+// the modulation line length and the initial delay (in seconds), the
+// density, and the echo time.
+typedef struct VerbLineSize
+{
+    ALfloat Mod;
+    ALfloat Delay;
+    ALfloat Density;
+    ALfloat Echo;
+} VerbLineSize;
+
 typedef struct ALverbState {
     // Must be first in all effects!
     ALeffectState state;
 
-    // All delay lines are allocated as a single buffer to reduce memory
-    // fragmentation and management code.
+    // All delay lines are allocated as a single buffer from the device's
+    // effect memory to reduce fragmentation and management code.
+    ALCdevice *Device;
     ALfloat  *SampleBuffer;
     ALuint    TotalSamples;
+    // The parameters the lines are currently long enough for.  They're only
+    // reallocated when an update needs more than this.
+    VerbLineSize LineSize;
     // Master effect low-pass filter (2 chained 1-pole filters).
     FILTER    LpFilter;
     ALfloat   LpHistory[2];
@@ -130,6 +155,20 @@ typedef struct ALverbState {
     // The current read offset for all delay lines.
     ALuint Offset;
 
+    // Working storage for processing a block.  The line blocks hold the
+    // delay line outputs, and then the values fed back into the lines.
+    ALfloat   DelayIn[MAX_UPDATE_SAMPLES];
+    ALfloat   EarlyIn[MAX_UPDATE_SAMPLES];
+    ALfloat   LateIn[MAX_UPDATE_SAMPLES];
+    ALfloat   DecoTaps[MAX_UPDATE_SAMPLES][4];
+    ALfloat   EarlyLine[MAX_UPDATE_SAMPLES][4];
+    ALfloat   LateLine[MAX_UPDATE_SAMPLES][4];
+    ALfloat   LateApLine[MAX_UPDATE_SAMPLES][4];
+    ALfloat   EchoLine[MAX_UPDATE_SAMPLES];
+    ALfloat   EchoApLine[MAX_UPDATE_SAMPLES];
+    ALfloat   EarlyOut[MAX_UPDATE_SAMPLES][4];
+    ALfloat   LateOut[MAX_UPDATE_SAMPLES][4];
+
     // The gain for each output channel (non-EAX path only; aliased from
     // Late.PanGain)
     ALfloat *Gain;
@@ -209,8 +248,9 @@ static __inline ALvoid RealizeLineOffset(ALfloat * sampleBuffer, DelayLine *Dela
 
 /* Calculates the delay line metrics and allocates the shared sample buffer
  * for all lines given a flag indicating whether or not to allocate the EAX-
- * related delays (eaxFlag) and the sample rate (frequency).  If an
- * allocation failure occurs, it returns AL_FALSE.
+ * related delays (eaxFlag) and the sample rate (frequency).  The variable
+ * lines are sized for the parameters in State->LineSize.  If an allocation
+ * failure occurs, it returns AL_FALSE.
  */
 static ALboolean AllocLines(ALboolean eaxFlag, ALuint frequency, ALverbState *State)
 {
@@ -218,30 +258,22 @@ static ALboolean AllocLines(ALboolean eaxFlag, ALuint frequency, ALverbState *St
     ALfloat length;
     ALfloat *newBuffer = NULL;
 
-    // All delay line lengths are calculated to accomodate the full range of
-    // lengths given their respective paramters.
     totalSamples = 0;
     if(eaxFlag)
     {
-        /* The modulator's line length is calculated from the maximum
-         * modulation time and depth coefficient, and halfed for the low-to-
-         * high frequency swing.  An additional sample is added to keep it
+        /* The modulator's line length is calculated from the modulation time
+         * and depth (see FitLines).  An additional sample is added to keep it
          * stable when there is no modulation.
          */
-        length = (AL_EAXREVERB_MAX_MODULATION_TIME * MODULATION_DEPTH_COEFF /
-                  2.0f) + (1.0f / frequency);
+        length = State->LineSize.Mod + (1.0f / frequency);
         totalSamples += CalcLineLength(length, totalSamples, frequency,
                                        &State->Mod.Delay);
     }
 
     // The initial delay is the sum of the reflections and late reverb
-    // delays.
-    if(eaxFlag)
-        length = AL_EAXREVERB_MAX_REFLECTIONS_DELAY +
-                 AL_EAXREVERB_MAX_LATE_REVERB_DELAY;
-    else
-        length = AL_REVERB_MAX_REFLECTIONS_DELAY +
-                 AL_REVERB_MAX_LATE_REVERB_DELAY;
+    // delays.  It and the decorrelator have an extra update's worth of
+    // samples, so a whole block can be written before their taps are read.
+    length = State->LineSize.Delay + ((ALfloat)MAX_UPDATE_SAMPLES / frequency);
     totalSamples += CalcLineLength(length, totalSamples, frequency,
                                    &State->Delay);
 
@@ -250,10 +282,12 @@ static ALboolean AllocLines(ALboolean eaxFlag, ALuint frequency, ALverbState *St
         totalSamples += CalcLineLength(EARLY_LINE_LENGTH[index], totalSamples,
                                        frequency, &State->Early.Delay[index]);
 
-    // The decorrelator line is calculated from the lowest reverb density (a
-    // parameter value of 1).
+    // The decorrelator line is calculated from the reverb density (the
+    // lowest density being a parameter value of 1).
     length = (DECO_FRACTION * DECO_MULTIPLIER * DECO_MULTIPLIER) *
-             LATE_LINE_LENGTH[0] * (1.0f + LATE_LINE_MULTIPLIER);
+             LATE_LINE_LENGTH[0] *
+             (1.0f + (State->LineSize.Density * LATE_LINE_MULTIPLIER));
+    length += (ALfloat)MAX_UPDATE_SAMPLES / frequency;
     totalSamples += CalcLineLength(length, totalSamples, frequency,
                                    &State->Decorrelator);
 
@@ -262,10 +296,11 @@ static ALboolean AllocLines(ALboolean eaxFlag, ALuint frequency, ALverbState *St
         totalSamples += CalcLineLength(ALLPASS_LINE_LENGTH[index], totalSamples,
                                        frequency, &State->Late.ApDelay[index]);
 
-    // The late delay lines are calculated from the lowest reverb density.
+    // The late delay lines are also calculated from the reverb density.
     for(index = 0;index < 4;index++)
     {
-        length = LATE_LINE_LENGTH[index] * (1.0f + LATE_LINE_MULTIPLIER);
+        length = LATE_LINE_LENGTH[index] *
+                 (1.0f + (State->LineSize.Density * LATE_LINE_MULTIPLIER));
         totalSamples += CalcLineLength(length, totalSamples, frequency,
                                        &State->Late.Delay[index]);
     }
@@ -275,15 +310,17 @@ static ALboolean AllocLines(ALboolean eaxFlag, ALuint frequency, ALverbState *St
         // The echo all-pass and delay lines.
         totalSamples += CalcLineLength(ECHO_ALLPASS_LENGTH, totalSamples,
                                        frequency, &State->Echo.ApDelay);
-        totalSamples += CalcLineLength(AL_EAXREVERB_MAX_ECHO_TIME, totalSamples,
+        totalSamples += CalcLineLength(State->LineSize.Echo, totalSamples,
                                        frequency, &State->Echo.Delay);
     }
 
     if(totalSamples != State->TotalSamples)
     {
-        newBuffer = realloc(State->SampleBuffer, sizeof(ALfloat) * totalSamples);
+        newBuffer = AllocEffectSamples(State->Device, totalSamples);
         if(newBuffer == NULL)
             return AL_FALSE;
+        FreeEffectSamples(State->Device, State->SampleBuffer,
+                          State->TotalSamples);
         State->SampleBuffer = newBuffer;
         State->TotalSamples = totalSamples;
     }
@@ -311,6 +348,35 @@ static ALboolean AllocLines(ALboolean eaxFlag, ALuint frequency, ALverbState *St
     return AL_TRUE;
 }
 
+/* Makes sure the variable delay lines are long enough for the given sizes,
+ * growing them (and clearing the reverb) if they aren't.  If they can't grow,
+ * they're left as they are and the sizes are clamped to what they hold.
+ */
+static ALvoid FitLines(ALboolean eaxFlag, ALuint frequency, ALverbState *State, VerbLineSize *size)
+{
+    VerbLineSize old = State->LineSize;
+
+    if(size->Mod <= old.Mod && size->Delay <= old.Delay &&
+       size->Density <= old.Density && size->Echo <= old.Echo)
+        return;
+
+    State->LineSize.Mod = __max(old.Mod, size->Mod);
+    State->LineSize.Delay = __max(old.Delay, size->Delay);
+    State->LineSize.Density = __max(old.Density, size->Density);
+    State->LineSize.Echo = __max(old.Echo, size->Echo);
+    if(AllocLines(eaxFlag, frequency, State))
+        return;
+
+    // Put the old layout back; the existing buffer already fits it.
+    State->LineSize = old;
+    AllocLines(eaxFlag, frequency, State);
+
+    size->Mod = __min(size->Mod, old.Mod);
+    size->Delay = __min(size->Delay, old.Delay);
+    size->Density = __min(size->Density, old.Density);
+    size->Echo = __min(size->Echo, old.Echo);
+}
+
 // Calculate a decay coefficient given the length of each cycle and the time
 // until the decay reaches -60 dB.
 static __inline ALfloat CalcDecayCoeff(ALfloat length, ALfloat decayTime)
@@ -663,33 +729,156 @@ static __inline ALvoid DelayLineIn(DelayLine *Delay, ALuint offset, ALfloat in)
     Delay->Line[offset&Delay->Mask] = in;
 }
 
-// Attenuated delay line output routine.
-static __inline ALfloat AttenuatedDelayLineOut(DelayLine *Delay, ALuint offset, ALfloat coeff)
+/* Block delay line input/output routines.  These copy a run of samples
+ * starting at the given offset, splitting it where the line wraps so the
+ * inner loops don't need to mask each index.  The stride allows reading into
+ * and writing from one column of a 4-channel block.
+ */
+static ALvoid DelayLineOutRun(const DelayLine *Delay, ALuint offset, ALfloat *out, ALuint stride, ALuint todo)
 {
-    return coeff * Delay->Line[offset&Delay->Mask];
+    while(todo > 0)
+    {
+        const ALuint pos = offset & Delay->Mask;
+        const ALfloat *src = &Delay->Line[pos];
+        ALuint count = __min(todo, Delay->Mask+1 - pos);
+
+        offset += count;
+        todo -= count;
+        while(count--)
+        {
+            *out = *(src++);
+            out += stride;
+        }
+    }
 }
 
-// Basic attenuated all-pass input/output routine.
-static __inline ALfloat AllpassInOut(DelayLine *Delay, ALuint outOffset, ALuint inOffset, ALfloat in, ALfloat feedCoeff, ALfloat coeff)
+static ALvoid DelayLineInRun(DelayLine *Delay, ALuint offset, const ALfloat *in, ALuint stride, ALuint todo)
 {
-    ALfloat out, feed;
+    while(todo > 0)
+    {
+        const ALuint pos = offset & Delay->Mask;
+        ALfloat *dst = &Delay->Line[pos];
+        ALuint count = __min(todo, Delay->Mask+1 - pos);
+
+        offset += count;
+        todo -= count;
+        while(count--)
+        {
+            *(dst++) = *in;
+            in += stride;
+        }
+    }
+}
 
-    out = DelayLineOut(Delay, outOffset);
-    feed = feedCoeff * in;
-    DelayLineIn(Delay, inOffset, (feedCoeff * (out - feed)) + in);
+/* Gather a block from each of a set of four delay lines into the rows of a
+ * 4-channel block, each line read at its own offset behind the current
+ * position.  The block is walked in runs where none of the lines wrap.
+ */
+static ALvoid DelayLineOut4(DelayLine *Delay, ALuint offset, const ALuint *taps, ALfloat (*out)[4], ALuint todo)
+{
+    ALuint pos[4];
+    ALuint index, count, i;
 
-    // The time-based attenuation is only applied to the delay output to
-    // keep it from affecting the feed-back path (which is already controlled
-    // by the all-pass feed coefficient).
-    return (coeff * out) - feed;
+    for(index = 0;index < 4;index++)
+        pos[index] = offset - taps[index];
+    while(todo > 0)
+    {
+        const ALfloat *src[4];
+
+        count = todo;
+        for(index = 0;index < 4;index++)
+        {
+            pos[index] &= Delay[index].Mask;
+            src[index] = &Delay[index].Line[pos[index]];
+            count = __min(count, Delay[index].Mask+1 - pos[index]);
+        }
+
+        for(i = 0;i < count;i++)
+        {
+            out[i][0] = src[0][i];
+            out[i][1] = src[1][i];
+            out[i][2] = src[2][i];
+            out[i][3] = src[3][i];
+        }
+
+        for(index = 0;index < 4;index++)
+            pos[index] += count;
+        out += count;
+        todo -= count;
+    }
+}
+
+// Feed a set of four delay lines from the rows of a 4-channel block.
+static ALvoid DelayLineIn4(DelayLine *Delay, ALuint offset, ALfloat (*in)[4], ALuint todo)
+{
+    ALuint pos[4];
+    ALuint index, count, i;
+
+    for(index = 0;index < 4;index++)
+        pos[index] = offset;
+    while(todo > 0)
+    {
+        ALfloat *dst[4];
+
+        count = todo;
+        for(index = 0;index < 4;index++)
+        {
+            pos[index] &= Delay[index].Mask;
+            dst[index] = &Delay[index].Line[pos[index]];
+            count = __min(count, Delay[index].Mask+1 - pos[index]);
+        }
+
+        for(i = 0;i < count;i++)
+        {
+            dst[0][i] = in[i][0];
+            dst[1][i] = in[i][1];
+            dst[2][i] = in[i][2];
+            dst[3][i] = in[i][3];
+        }
+
+        for(index = 0;index < 4;index++)
+            pos[index] += count;
+        in += count;
+        todo -= count;
+    }
+}
+
+/* Calculate the largest block that can be processed at once.  The feed-back
+ * lines are read for the whole block before they're written, so the block
+ * can't be longer than their shortest delay.  The initial delay and
+ * decorrelator lines are written before they're read, so the block also
+ * can't be long enough to overwrite their furthest tap.
+ */
+static ALuint CalcBlockLength(const ALverbState *State, ALboolean eaxFlag)
+{
+    ALuint todo = MAX_UPDATE_SAMPLES;
+    ALuint index;
+
+    for(index = 0;index < 4;index++)
+    {
+        todo = __min(todo, State->Early.Offset[index]);
+        todo = __min(todo, State->Late.ApOffset[index]);
+        todo = __min(todo, State->Late.Offset[index]);
+    }
+    if(eaxFlag)
+    {
+        todo = __min(todo, State->Echo.Offset);
+        todo = __min(todo, State->Echo.ApOffset);
+    }
+    todo = __min(todo, State->Delay.Mask+1 - State->DelayTap[1]);
+    todo = __min(todo, State->Decorrelator.Mask+1 - State->DecoTap[2]);
+
+    // Degenerate line lengths are only possible at absurdly low sample
+    // rates, but don't get stuck on them.
+    return __max(todo, 1);
 }
 
 // Given an input sample, this function produces modulation for the late
 // reverb.
-static __inline ALfloat EAXModulation(ALverbState *State, ALfloat in)
+static __inline ALfloat EAXModulation(ALverbState *State, ALuint offset, ALfloat in)
 {
     ALfloat sinus, frac;
-    ALuint offset;
+    ALuint delay;
     ALfloat out0, out1;
 
     // Calculate the sinus rythm (dependent on modulation time and the
@@ -704,15 +893,15 @@ static __inline ALfloat EAXModulation(ALverbState *State, ALfloat in)
                              State->Mod.Coeff);
 
     // Calculate the read offset and fraction between it and the next sample.
-    frac   = (1.0f + (State->Mod.Filter * sinus));
-    offset = (ALuint)frac;
-    frac  -= offset;
+    frac  = (1.0f + (State->Mod.Filter * sinus));
+    delay = (ALuint)frac;
+    frac -= delay;
 
     // Get the two samples crossed by the offset, and feed the delay line
     // with the next input sample.
-    out0 = DelayLineOut(&State->Mod.Delay, State->Offset - offset);
-    out1 = DelayLineOut(&State->Mod.Delay, State->Offset - offset - 1);
-    DelayLineIn(&State->Mod.Delay, State->Offset, in);
+    out0 = DelayLineOut(&State->Mod.Delay, offset - delay);
+    out1 = DelayLineOut(&State->Mod.Delay, offset - delay - 1);
+    DelayLineIn(&State->Mod.Delay, offset, in);
 
     // Step the modulation index forward, keeping it bound to its range.
     State->Mod.Index = (State->Mod.Index + 1) % State->Mod.Range;
@@ -722,25 +911,28 @@ static __inline ALfloat EAXModulation(ALverbState *State, ALfloat in)
     return lerp(out0, out1, frac);
 }
 
-// Delay line output routine for early reflections.
-static __inline ALfloat EarlyDelayLineOut(ALverbState *State, ALuint index)
-{
-    return AttenuatedDelayLineOut(&State->Early.Delay[index],
-                                  State->Offset - State->Early.Offset[index],
-                                  State->Early.Coeff[index]);
-}
+/* The early and late line sets are processed 4-wide.  The delay line reads
+ * and writes are gathered and scattered a block at a time, and everything in
+ * between is done in a single SIMD register when available.
+ */
 
-// Given an input sample, this function produces four-channel output for the
-// early reflections.
-static __inline ALvoid EarlyReflection(ALverbState *State, ALfloat in, ALfloat *out)
+// Given a block of input samples, this function produces four-channel output
+// for the early reflections.
+static ALvoid EarlyReflection(ALverbState *State, const ALfloat *in, ALuint todo)
 {
-    ALfloat d[4], v, f[4];
+    ALfloat (*d)[4] = State->EarlyLine;
+    ALfloat (*out)[4] = State->EarlyOut;
+    const ALfloat gain = State->Early.Gain;
+    ALfloat coeff[4];
+    ALuint i;
 
-    // Obtain the decayed results of each early delay line.
-    d[0] = EarlyDelayLineOut(State, 0);
-    d[1] = EarlyDelayLineOut(State, 1);
-    d[2] = EarlyDelayLineOut(State, 2);
-    d[3] = EarlyDelayLineOut(State, 3);
+    // Keep local copies of the coefficients, so they aren't reloaded after
+    // every write to the line blocks.
+    for(i = 0;i < 4;i++)
+        coeff[i] = State->Early.Coeff[i];
+
+    // Obtain the results of each early delay line.
+    DelayLineOut4(State->Early.Delay, State->Offset, State->Early.Offset, d, todo);
 
     /* The following uses a lossless scattering junction from waveguide
      * theory.  It actually amounts to a householder mixing matrix, which
@@ -752,79 +944,82 @@ static __inline ALvoid EarlyReflection(ALverbState *State, ALfloat in, ALfloat *
      * v = 2/N /   d_i
      *         ---
      *         i=1
+     *
+     * The junction is loaded with the input, and the feed values for the
+     * delay lines are then v - d_i.  They replace the line results in place.
      */
-    v = (d[0] + d[1] + d[2] + d[3]) * 0.5f;
-    // The junction is loaded with the input here.
-    v += in;
-
-    // Calculate the feed values for the delay lines.
-    f[0] = v - d[0];
-    f[1] = v - d[1];
-    f[2] = v - d[2];
-    f[3] = v - d[3];
+    for(i = 0;i < todo;i++)
+    {
+#if defined(USE_SSE2)
+        __m128 dv, v, fv;
+
+        // Decay the delay line results.
+        dv = _mm_mul_ps(_mm_loadu_ps(coeff), _mm_loadu_ps(d[i]));
+
+        // Sum across the register.
+        v = _mm_add_ps(dv, _mm_shuffle_ps(dv, dv, _MM_SHUFFLE(2,3,0,1)));
+        v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1,0,3,2)));
+        v = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(0.5f)), _mm_set1_ps(in[i]));
+
+        fv = _mm_sub_ps(v, dv);
+        _mm_storeu_ps(d[i], fv);
+        _mm_storeu_ps(out[i], _mm_mul_ps(fv, _mm_set1_ps(gain)));
+#elif defined(USE_NEON)
+        float32x4_t dv, v, fv;
+        float32x2_t s;
+
+        // Decay the delay line results.
+        dv = vmulq_f32(vld1q_f32(coeff), vld1q_f32(d[i]));
+
+        // Sum across the register.
+        s = vadd_f32(vget_low_f32(dv), vget_high_f32(dv));
+        s = vpadd_f32(s, s);
+        v = vaddq_f32(vmulq_n_f32(vdupq_lane_f32(s, 0), 0.5f), vdupq_n_f32(in[i]));
+
+        fv = vsubq_f32(v, dv);
+        vst1q_f32(d[i], fv);
+        vst1q_f32(out[i], vmulq_n_f32(fv, gain));
+#else
+        ALfloat v;
+
+        // Decay the delay line results.
+        d[i][0] *= coeff[0];
+        d[i][1] *= coeff[1];
+        d[i][2] *= coeff[2];
+        d[i][3] *= coeff[3];
+
+        v = (d[i][0] + d[i][1] + d[i][2] + d[i][3]) * 0.5f;
+        v += in[i];
+
+        d[i][0] = v - d[i][0];
+        d[i][1] = v - d[i][1];
+        d[i][2] = v - d[i][2];
+        d[i][3] = v - d[i][3];
+
+        // Output the results of the junction for all four channels.
+        out[i][0] = gain * d[i][0];
+        out[i][1] = gain * d[i][1];
+        out[i][2] = gain * d[i][2];
+        out[i][3] = gain * d[i][3];
+#endif
+    }
 
     // Re-feed the delay lines.
-    DelayLineIn(&State->Early.Delay[0], State->Offset, f[0]);
-    DelayLineIn(&State->Early.Delay[1], State->Offset, f[1]);
-    DelayLineIn(&State->Early.Delay[2], State->Offset, f[2]);
-    DelayLineIn(&State->Early.Delay[3], State->Offset, f[3]);
-
-    // Output the results of the junction for all four channels.
-    out[0] = State->Early.Gain * f[0];
-    out[1] = State->Early.Gain * f[1];
-    out[2] = State->Early.Gain * f[2];
-    out[3] = State->Early.Gain * f[3];
-}
-
-// All-pass input/output routine for late reverb.
-static __inline ALfloat LateAllPassInOut(ALverbState *State, ALuint index, ALfloat in)
-{
-    return AllpassInOut(&State->Late.ApDelay[index],
-                        State->Offset - State->Late.ApOffset[index],
-                        State->Offset, in, State->Late.ApFeedCoeff,
-                        State->Late.ApCoeff[index]);
-}
-
-// Delay line output routine for late reverb.
-static __inline ALfloat LateDelayLineOut(ALverbState *State, ALuint index)
-{
-    return AttenuatedDelayLineOut(&State->Late.Delay[index],
-                                  State->Offset - State->Late.Offset[index],
-                                  State->Late.Coeff[index]);
-}
-
-// Low-pass filter input/output routine for late reverb.
-static __inline ALfloat LateLowPassInOut(ALverbState *State, ALuint index, ALfloat in)
-{
-    in = lerp(in, State->Late.LpSample[index], State->Late.LpCoeff[index]);
-    State->Late.LpSample[index] = in;
-    return in;
+    DelayLineIn4(State->Early.Delay, State->Offset, d, todo);
 }
 
-// Given four decorrelated input samples, this function produces four-channel
-// output for the late reverb.
-static __inline ALvoid LateReverb(ALverbState *State, ALfloat *in, ALfloat *out)
+// Given a block of four decorrelated input samples, this function produces
+// four-channel output for the late reverb.
+static ALvoid LateReverb(ALverbState *State, ALfloat (*in)[4], ALuint todo)
 {
-    ALfloat d[4], f[4];
-
-    // Obtain the decayed results of the cyclical delay lines, and add the
-    // corresponding input channels.  Then pass the results through the
-    // low-pass filters.
-
-    // This is where the feed-back cycles from line 0 to 1 to 3 to 2 and back
-    // to 0.
-    d[0] = LateLowPassInOut(State, 2, in[2] + LateDelayLineOut(State, 2));
-    d[1] = LateLowPassInOut(State, 0, in[0] + LateDelayLineOut(State, 0));
-    d[2] = LateLowPassInOut(State, 3, in[3] + LateDelayLineOut(State, 3));
-    d[3] = LateLowPassInOut(State, 1, in[1] + LateDelayLineOut(State, 1));
-
-    // To help increase diffusion, run each line through an all-pass filter.
-    // When there is no diffusion, the shortest all-pass filter will feed the
-    // shortest delay line.
-    d[0] = LateAllPassInOut(State, 0, d[0]);
-    d[1] = LateAllPassInOut(State, 1, d[1]);
-    d[2] = LateAllPassInOut(State, 2, d[2]);
-    d[3] = LateAllPassInOut(State, 3, d[3]);
+    ALfloat (*d)[4] = State->LateLine;
+    ALfloat (*a)[4] = State->LateApLine;
+    ALfloat (*out)[4] = State->LateOut;
+    const ALfloat gain = State->Late.Gain;
+    const ALfloat apFeedCoeff = State->Late.ApFeedCoeff;
+    const ALfloat mixCoeff = State->Late.MixCoeff;
+    ALfloat coeff[4], apCoeff[4], lpCoeff[4], lpSample[4];
+    ALuint i;
 
     /* Late reverb is done with a modified feed-back delay network (FDN)
      * topology.  Four input lines are each fed through their own all-pass
@@ -853,129 +1048,291 @@ static __inline ALvoid LateReverb(ALverbState *State, ALfloat *in, ALfloat *out)
      * the cyclical delay line coefficients.  Thus only the y coefficient is
      * applied when mixing, and is modified to be:  y / x.
      */
-    f[0] = d[0] + (State->Late.MixCoeff * (         d[1] + -d[2] + d[3]));
-    f[1] = d[1] + (State->Late.MixCoeff * (-d[0]         +  d[2] + d[3]));
-    f[2] = d[2] + (State->Late.MixCoeff * ( d[0] + -d[1]         + d[3]));
-    f[3] = d[3] + (State->Late.MixCoeff * (-d[0] + -d[1] + -d[2]       ));
-
-    // Output the results of the matrix for all four channels, attenuated by
-    // the late reverb gain (which is attenuated by the 'x' mix coefficient).
-    out[0] = State->Late.Gain * f[0];
-    out[1] = State->Late.Gain * f[1];
-    out[2] = State->Late.Gain * f[2];
-    out[3] = State->Late.Gain * f[3];
-
-    // Re-feed the cyclical delay lines.
-    DelayLineIn(&State->Late.Delay[0], State->Offset, f[0]);
-    DelayLineIn(&State->Late.Delay[1], State->Offset, f[1]);
-    DelayLineIn(&State->Late.Delay[2], State->Offset, f[2]);
-    DelayLineIn(&State->Late.Delay[3], State->Offset, f[3]);
+
+    // Obtain the results of the cyclical delay lines, and the all-pass
+    // outputs.  Both are replaced in place by the values to feed back.
+    DelayLineOut4(State->Late.Delay, State->Offset, State->Late.Offset, d, todo);
+    DelayLineOut4(State->Late.ApDelay, State->Offset, State->Late.ApOffset, a, todo);
+
+    // Keep local copies of the coefficients and filter state, so they aren't
+    // reloaded after every write to the line blocks.
+    for(i = 0;i < 4;i++)
+    {
+        coeff[i] = State->Late.Coeff[i];
+        apCoeff[i] = State->Late.ApCoeff[i];
+        lpCoeff[i] = State->Late.LpCoeff[i];
+        lpSample[i] = State->Late.LpSample[i];
+    }
+
+    for(i = 0;i < todo;i++)
+    {
+#if defined(USE_SSE2)
+        __m128 dv, av, lp, feed, fc, fv;
+
+        // Decay the cyclical line results, add the corresponding input
+        // channels, and pass them through the low-pass filters.
+        dv = _mm_add_ps(_mm_loadu_ps(in[i]),
+                        _mm_mul_ps(_mm_loadu_ps(coeff), _mm_loadu_ps(d[i])));
+        lp = _mm_loadu_ps(lpSample);
+        dv = _mm_add_ps(dv, _mm_mul_ps(_mm_sub_ps(lp, dv),
+                                       _mm_loadu_ps(lpCoeff)));
+        _mm_storeu_ps(lpSample, dv);
+
+        // This is where the feed-back cycles from line 0 to 1 to 3 to 2 and
+        // back to 0.
+        dv = _mm_shuffle_ps(dv, dv, _MM_SHUFFLE(1,3,0,2));
+
+        // To help increase diffusion, run each line through an all-pass
+        // filter.  When there is no diffusion, the shortest all-pass filter
+        // will feed the shortest delay line.
+        av = _mm_loadu_ps(a[i]);
+        fc = _mm_set1_ps(apFeedCoeff);
+        feed = _mm_mul_ps(fc, dv);
+        _mm_storeu_ps(a[i], _mm_add_ps(_mm_mul_ps(fc, _mm_sub_ps(av, feed)), dv));
+        dv = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(apCoeff), av), feed);
+
+        // Apply the mixing matrix as three shuffled and sign-flipped copies
+        // of the line results.
+        fv = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(dv, dv, _MM_SHUFFLE(0,0,0,1)),
+                                  _mm_setr_ps( 1.0f, -1.0f,  1.0f, -1.0f)),
+                       _mm_mul_ps(_mm_shuffle_ps(dv, dv, _MM_SHUFFLE(1,1,2,2)),
+                                  _mm_setr_ps(-1.0f,  1.0f, -1.0f, -1.0f))),
+            _mm_mul_ps(_mm_shuffle_ps(dv, dv, _MM_SHUFFLE(2,3,3,3)),
+                       _mm_setr_ps( 1.0f,  1.0f,  1.0f, -1.0f)));
+        fv = _mm_add_ps(dv, _mm_mul_ps(_mm_set1_ps(mixCoeff), fv));
+
+        _mm_storeu_ps(d[i], fv);
+        _mm_storeu_ps(out[i], _mm_mul_ps(fv, _mm_set1_ps(gain)));
+#elif defined(USE_NEON)
+        static const ALfloat sign0[4] = {  1.0f, -1.0f,  1.0f, -1.0f };
+        static const ALfloat sign1[4] = { -1.0f,  1.0f, -1.0f, -1.0f };
+        static const ALfloat sign2[4] = {  1.0f,  1.0f,  1.0f, -1.0f };
+        float32x4_t dv, av, lp, feed, fv;
+        ALfloat t[4], m0[4], m1[4], m2[4];
+
+        // Decay the cyclical line results, add the corresponding input
+        // channels, and pass them through the low-pass filters.
+        dv = vaddq_f32(vld1q_f32(in[i]), vmulq_f32(vld1q_f32(coeff),
+                                                   vld1q_f32(d[i])));
+        lp = vld1q_f32(lpSample);
+        dv = vaddq_f32(dv, vmulq_f32(vsubq_f32(lp, dv),
+                                     vld1q_f32(lpCoeff)));
+        vst1q_f32(lpSample, dv);
+
+        // This is where the feed-back cycles from line 0 to 1 to 3 to 2 and
+        // back to 0.
+        vst1q_f32(t, dv);
+        m0[0] = t[2]; m0[1] = t[0]; m0[2] = t[3]; m0[3] = t[1];
+        dv = vld1q_f32(m0);
+
+        // To help increase diffusion, run each line through an all-pass
+        // filter.  When there is no diffusion, the shortest all-pass filter
+        // will feed the shortest delay line.
+        av = vld1q_f32(a[i]);
+        feed = vmulq_n_f32(dv, apFeedCoeff);
+        vst1q_f32(a[i], vaddq_f32(vmulq_n_f32(vsubq_f32(av, feed),
+                                              apFeedCoeff), dv));
+        dv = vsubq_f32(vmulq_f32(vld1q_f32(apCoeff), av), feed);
+
+        // Apply the mixing matrix as three shuffled and sign-flipped copies
+        // of the line results.
+        vst1q_f32(t, dv);
+        m0[0] = t[1]; m0[1] = t[0]; m0[2] = t[0]; m0[3] = t[0];
+        m1[0] = t[2]; m1[1] = t[2]; m1[2] = t[1]; m1[3] = t[1];
+        m2[0] = t[3]; m2[1] = t[3]; m2[2] = t[3]; m2[3] = t[2];
+        fv = vaddq_f32(vaddq_f32(vmulq_f32(vld1q_f32(m0), vld1q_f32(sign0)),
+                                 vmulq_f32(vld1q_f32(m1), vld1q_f32(sign1))),
+                       vmulq_f32(vld1q_f32(m2), vld1q_f32(sign2)));
+        fv = vaddq_f32(dv, vmulq_n_f32(fv, mixCoeff));
+
+        vst1q_f32(d[i], fv);
+        vst1q_f32(out[i], vmulq_n_f32(fv, gain));
+#else
+        ALuint index;
+        ALfloat t[4], feed;
+
+        // Decay the cyclical line results, add the corresponding input
+        // channels, and pass them through the low-pass filters.
+        for(index = 0;index < 4;index++)
+        {
+            t[index] = in[i][index] + (coeff[index] * d[i][index]);
+            t[index] = lerp(t[index], lpSample[index],
+                            lpCoeff[index]);
+            lpSample[index] = t[index];
+        }
+
+        // This is where the feed-back cycles from line 0 to 1 to 3 to 2 and
+        // back to 0.
+        d[i][0] = t[2];
+        d[i][1] = t[0];
+        d[i][2] = t[3];
+        d[i][3] = t[1];
+
+        // To help increase diffusion, run each line through an all-pass
+        // filter.  When there is no diffusion, the shortest all-pass filter
+        // will feed the shortest delay line.  The time-based attenuation is
+        // only applied to the delay output to keep it from affecting the
+        // feed-back path.
+        for(index = 0;index < 4;index++)
+        {
+            feed = apFeedCoeff * d[i][index];
+            t[index] = a[i][index];
+            a[i][index] = (apFeedCoeff * (t[index] - feed)) + d[i][index];
+            t[index] = (apCoeff[index] * t[index]) - feed;
+        }
+
+        d[i][0] = t[0] + (mixCoeff * (         t[1] + -t[2] + t[3]));
+        d[i][1] = t[1] + (mixCoeff * (-t[0]         +  t[2] + t[3]));
+        d[i][2] = t[2] + (mixCoeff * ( t[0] + -t[1]         + t[3]));
+        d[i][3] = t[3] + (mixCoeff * (-t[0] + -t[1] + -t[2]       ));
+
+        // Output the results of the matrix for all four channels, attenuated
+        // by the late reverb gain (which is attenuated by the 'x' mix
+        // coefficient).
+        out[i][0] = gain * d[i][0];
+        out[i][1] = gain * d[i][1];
+        out[i][2] = gain * d[i][2];
+        out[i][3] = gain * d[i][3];
+#endif
+    }
+
+    for(i = 0;i < 4;i++)
+        State->Late.LpSample[i] = lpSample[i];
+
+    // Re-feed the all-pass and cyclical delay lines.
+    DelayLineIn4(State->Late.ApDelay, State->Offset, a, todo);
+    DelayLineIn4(State->Late.Delay, State->Offset, d, todo);
 }
 
-// Given an input sample, this function mixes echo into the four-channel late
-// reverb.
-static __inline ALvoid EAXEcho(ALverbState *State, ALfloat in, ALfloat *late)
+// Given a block of input samples, this function mixes echo into the four-
+// channel late reverb.
+static ALvoid EAXEcho(ALverbState *State, const ALfloat *in, ALuint todo)
 {
-    ALfloat out, feed;
-
-    // Get the latest attenuated echo sample for output.
-    feed = AttenuatedDelayLineOut(&State->Echo.Delay,
-                                  State->Offset - State->Echo.Offset,
-                                  State->Echo.Coeff);
-
-    // Mix the output into the late reverb channels.
-    out = State->Echo.MixCoeff[0] * feed;
-    late[0] = (State->Echo.MixCoeff[1] * late[0]) + out;
-    late[1] = (State->Echo.MixCoeff[1] * late[1]) + out;
-    late[2] = (State->Echo.MixCoeff[1] * late[2]) + out;
-    late[3] = (State->Echo.MixCoeff[1] * late[3]) + out;
-
-    // Mix the energy-attenuated input with the output and pass it through
-    // the echo low-pass filter.
-    feed += State->Echo.DensityGain * in;
-    feed = lerp(feed, State->Echo.LpSample, State->Echo.LpCoeff);
-    State->Echo.LpSample = feed;
-
-    // Then the echo all-pass filter.
-    feed = AllpassInOut(&State->Echo.ApDelay,
-                        State->Offset - State->Echo.ApOffset,
-                        State->Offset, feed, State->Echo.ApFeedCoeff,
-                        State->Echo.ApCoeff);
-
-    // Feed the delay with the mixed and filtered sample.
-    DelayLineIn(&State->Echo.Delay, State->Offset, feed);
+    ALfloat *delay = State->EchoLine;
+    ALfloat *ap = State->EchoApLine;
+    ALfloat (*late)[4] = State->LateOut;
+    const ALfloat coeff = State->Echo.Coeff;
+    const ALfloat densityGain = State->Echo.DensityGain;
+    const ALfloat apFeedCoeff = State->Echo.ApFeedCoeff;
+    const ALfloat apCoeff = State->Echo.ApCoeff;
+    const ALfloat lpCoeff = State->Echo.LpCoeff;
+    const ALfloat echoMix = State->Echo.MixCoeff[0];
+    const ALfloat lateMix = State->Echo.MixCoeff[1];
+    ALfloat lpSample = State->Echo.LpSample;
+    ALfloat out, feed, apOut, apFeed;
+    ALuint i;
+
+    // Get the echo and all-pass line outputs.  Like the late lines, both are
+    // replaced in place by the values to feed back.
+    DelayLineOutRun(&State->Echo.Delay, State->Offset - State->Echo.Offset,
+                    delay, 1, todo);
+    DelayLineOutRun(&State->Echo.ApDelay, State->Offset - State->Echo.ApOffset,
+                    ap, 1, todo);
+
+    for(i = 0;i < todo;i++)
+    {
+        // Get the latest attenuated echo sample for output.
+        feed = coeff * delay[i];
+
+        // Mix the output into the late reverb channels.
+        out = echoMix * feed;
+        late[i][0] = (lateMix * late[i][0]) + out;
+        late[i][1] = (lateMix * late[i][1]) + out;
+        late[i][2] = (lateMix * late[i][2]) + out;
+        late[i][3] = (lateMix * late[i][3]) + out;
+
+        // Mix the energy-attenuated input with the output and pass it through
+        // the echo low-pass filter.
+        feed += densityGain * in[i];
+        feed = lerp(feed, lpSample, lpCoeff);
+        lpSample = feed;
+
+        // Then the echo all-pass filter.
+        apOut = ap[i];
+        apFeed = apFeedCoeff * feed;
+        ap[i] = (apFeedCoeff * (apOut - apFeed)) + feed;
+
+        // Feed the delay with the mixed and filtered sample.
+        delay[i] = (apCoeff * apOut) - apFeed;
+    }
+
+    State->Echo.LpSample = lpSample;
+
+    DelayLineInRun(&State->Echo.ApDelay, State->Offset, ap, 1, todo);
+    DelayLineInRun(&State->Echo.Delay, State->Offset, delay, 1, todo);
 }
 
-// Perform the non-EAX reverb pass on a given input sample, resulting in
-// four-channel output.
-static __inline ALvoid VerbPass(ALverbState *State, ALfloat in, ALfloat *early, ALfloat *late)
+// Feed a block of filtered input into the initial delay, and run the early
+// reflections and late reverb from its taps.
+static ALvoid VerbLines(ALverbState *State, ALuint todo)
 {
-    ALfloat feed, taps[4];
-
-    // Low-pass filter the incoming sample.
-    in = lpFilter2P(&State->LpFilter, 0, in);
+    ALfloat (*taps)[4] = State->DecoTaps;
+    ALuint i;
 
     // Feed the initial delay line.
-    DelayLineIn(&State->Delay, State->Offset, in);
+    DelayLineInRun(&State->Delay, State->Offset, State->DelayIn, 1, todo);
 
-    // Calculate the early reflection from the first delay tap.
-    in = DelayLineOut(&State->Delay, State->Offset - State->DelayTap[0]);
-    EarlyReflection(State, in, early);
+    // Calculate the early reflections from the first delay tap.
+    DelayLineOutRun(&State->Delay, State->Offset - State->DelayTap[0],
+                    State->EarlyIn, 1, todo);
+    EarlyReflection(State, State->EarlyIn, todo);
 
     // Feed the decorrelator from the energy-attenuated output of the second
     // delay tap.
-    in = DelayLineOut(&State->Delay, State->Offset - State->DelayTap[1]);
-    feed = in * State->Late.DensityGain;
-    DelayLineIn(&State->Decorrelator, State->Offset, feed);
+    DelayLineOutRun(&State->Delay, State->Offset - State->DelayTap[1],
+                    State->LateIn, 1, todo);
+    for(i = 0;i < todo;i++)
+        taps[i][0] = State->LateIn[i] * State->Late.DensityGain;
+    DelayLineInRun(&State->Decorrelator, State->Offset, &taps[0][0], 4, todo);
 
     // Calculate the late reverb from the decorrelator taps.
-    taps[0] = feed;
-    taps[1] = DelayLineOut(&State->Decorrelator, State->Offset - State->DecoTap[0]);
-    taps[2] = DelayLineOut(&State->Decorrelator, State->Offset - State->DecoTap[1]);
-    taps[3] = DelayLineOut(&State->Decorrelator, State->Offset - State->DecoTap[2]);
-    LateReverb(State, taps, late);
-
-    // Step all delays forward one sample.
-    State->Offset++;
+    DelayLineOutRun(&State->Decorrelator, State->Offset - State->DecoTap[0],
+                    &taps[0][1], 4, todo);
+    DelayLineOutRun(&State->Decorrelator, State->Offset - State->DecoTap[1],
+                    &taps[0][2], 4, todo);
+    DelayLineOutRun(&State->Decorrelator, State->Offset - State->DecoTap[2],
+                    &taps[0][3], 4, todo);
+    LateReverb(State, taps, todo);
 }
 
-// Perform the EAX reverb pass on a given input sample, resulting in four-
-// channel output.
-static __inline ALvoid EAXVerbPass(ALverbState *State, ALfloat in, ALfloat *early, ALfloat *late)
+// Perform the non-EAX reverb pass on a block of input samples, resulting in
+// four-channel output.
+static ALvoid VerbPass(ALverbState *State, const ALfloat *in, ALuint todo)
 {
-    ALfloat feed, taps[4];
+    ALuint i;
 
-    // Low-pass filter the incoming sample.
-    in = lpFilter2P(&State->LpFilter, 0, in);
+    // Low-pass filter the incoming samples.
+    for(i = 0;i < todo;i++)
+        State->DelayIn[i] = lpFilter2P(&State->LpFilter, 0, in[i]);
 
-    // Perform any modulation on the input.
-    in = EAXModulation(State, in);
+    VerbLines(State, todo);
 
-    // Feed the initial delay line.
-    DelayLineIn(&State->Delay, State->Offset, in);
+    // Step all delays forward.
+    State->Offset += todo;
+}
 
-    // Calculate the early reflection from the first delay tap.
-    in = DelayLineOut(&State->Delay, State->Offset - State->DelayTap[0]);
-    EarlyReflection(State, in, early);
+// Perform the EAX reverb pass on a block of input samples, resulting in four-
+// channel output.
+static ALvoid EAXVerbPass(ALverbState *State, const ALfloat *in, ALuint todo)
+{
+    ALuint i;
 
-    // Feed the decorrelator from the energy-attenuated output of the second
-    // delay tap.
-    in = DelayLineOut(&State->Delay, State->Offset - State->DelayTap[1]);
-    feed = in * State->Late.DensityGain;
-    DelayLineIn(&State->Decorrelator, State->Offset, feed);
+    // Low-pass filter the incoming samples, and perform any modulation on
+    // them.  The modulation delay is too short to process in blocks.
+    for(i = 0;i < todo;i++)
+    {
+        ALfloat smp = lpFilter2P(&State->LpFilter, 0, in[i]);
+        State->DelayIn[i] = EAXModulation(State, State->Offset + i, smp);
+    }
 
-    // Calculate the late reverb from the decorrelator taps.
-    taps[0] = feed;
-    taps[1] = DelayLineOut(&State->Decorrelator, State->Offset - State->DecoTap[0]);
-    taps[2] = DelayLineOut(&State->Decorrelator, State->Offset - State->DecoTap[1]);
-    taps[3] = DelayLineOut(&State->Decorrelator, State->Offset - State->DecoTap[2]);
-    LateReverb(State, taps, late);
+    VerbLines(State, todo);
 
     // Calculate and mix in any echo.
-    EAXEcho(State, in, late);
+    EAXEcho(State, State->LateIn, todo);
 
-    // Step all delays forward one sample.
-    State->Offset++;
+    // Step all delays forward.
+    State->Offset += todo;
 }
 
 // This destroys the reverb state.  It should be called only when the effect
@@ -985,7 +1342,9 @@ static ALvoid VerbDestroy(ALeffectState *effect)
     ALverbState *State = (ALverbState*)effect;
     if(State)
     {
-        free(State->SampleBuffer);
+        if(State->Device)
+            FreeEffectSamples(State->Device, State->SampleBuffer,
+                              State->TotalSamples);
         State->SampleBuffer = NULL;
         free(State);
     }
@@ -1001,6 +1360,7 @@ static ALboolean VerbDeviceUpdate(ALeffectState *effect, ALCdevice *Device)
     ALuint index;
 
     // Allocate the delay lines.
+    State->Device = Device;
     if(!AllocLines(AL_FALSE, frequency, State))
         return AL_FALSE;
 
@@ -1034,6 +1394,7 @@ static ALboolean EAXVerbDeviceUpdate(ALeffectState *effect, ALCdevice *Device)
     ALuint frequency = Device->Frequency, index;
 
     // Allocate the delay lines.
+    State->Device = Device;
     if(!AllocLines(AL_TRUE, frequency, State))
         return AL_FALSE;
 
@@ -1068,6 +1429,17 @@ static ALvoid VerbUpdate(ALeffectState *effect, ALCcontext *Context, const ALeff
     ALverbState *State = (ALverbState*)effect;
     ALuint frequency = Context->Device->Frequency;
     ALfloat cw, x, y, hfRatio;
+    ALfloat earlyDelay, lateDelay;
+    VerbLineSize size;
+
+    // Make sure the delay lines fit the new parameters.
+    size.Mod = 0.0f;
+    size.Delay = Effect->Reverb.ReflectionsDelay + Effect->Reverb.LateReverbDelay;
+    size.Density = Effect->Reverb.Density;
+    size.Echo = 0.0f;
+    FitLines(AL_FALSE, frequency, State, &size);
+    earlyDelay = __min(Effect->Reverb.ReflectionsDelay, size.Delay);
+    lateDelay = __min(Effect->Reverb.LateReverbDelay, size.Delay - earlyDelay);
 
     // Calculate the master low-pass filter (from the master effect HF gain).
     cw = CalcI3DL2HFreq(Effect->Reverb.HFReference, frequency);
@@ -1075,15 +1447,14 @@ static ALvoid VerbUpdate(ALeffectState *effect, ALCcontext *Context, const ALeff
     State->LpFilter.coeff = lpCoeffCalc(Effect->Reverb.GainHF, cw);
 
     // Update the initial effect delay.
-    UpdateDelayLine(Effect->Reverb.ReflectionsDelay,
-                    Effect->Reverb.LateReverbDelay, frequency, State);
+    UpdateDelayLine(earlyDelay, lateDelay, frequency, State);
 
     // Update the early lines.
     UpdateEarlyLines(Effect->Reverb.Gain, Effect->Reverb.ReflectionsGain,
                      Effect->Reverb.LateReverbDelay, State);
 
     // Update the decorrelator.
-    UpdateDecorrelator(Effect->Reverb.Density, frequency, State);
+    UpdateDecorrelator(size.Density, frequency, State);
 
     // Get the mixing matrix coefficients (x and y).
     CalcMatrixCoeffs(Effect->Reverb.Diffusion, &x, &y);
@@ -1099,7 +1470,7 @@ static ALvoid VerbUpdate(ALeffectState *effect, ALCcontext *Context, const ALeff
 
     // Update the late lines.
     UpdateLateLines(Effect->Reverb.Gain, Effect->Reverb.LateReverbGain,
-                    x, Effect->Reverb.Density, Effect->Reverb.DecayTime,
+                    x, size.Density, Effect->Reverb.DecayTime,
                     Effect->Reverb.Diffusion, hfRatio, cw, frequency, State);
 }
 
@@ -1110,6 +1481,26 @@ static ALvoid EAXVerbUpdate(ALeffectState *effect, ALCcontext *Context, const AL
     ALverbState *State = (ALverbState*)effect;
     ALuint frequency = Context->Device->Frequency;
     ALfloat cw, x, y, hfRatio;
+    ALfloat earlyDelay, lateDelay, modDepth;
+    VerbLineSize size;
+
+    /* Make sure the delay lines fit the new parameters.  The modulation line
+     * is sized from the modulation time and depth coefficient, and halfed
+     * for the low-to-high frequency swing.
+     */
+    size.Mod = Effect->Reverb.ModulationTime * Effect->Reverb.ModulationDepth *
+               MODULATION_DEPTH_COEFF / 2.0f;
+    size.Delay = Effect->Reverb.ReflectionsDelay + Effect->Reverb.LateReverbDelay;
+    size.Density = Effect->Reverb.Density;
+    size.Echo = Effect->Reverb.EchoTime;
+    FitLines(AL_TRUE, frequency, State, &size);
+    earlyDelay = __min(Effect->Reverb.ReflectionsDelay, size.Delay);
+    lateDelay = __min(Effect->Reverb.LateReverbDelay, size.Delay - earlyDelay);
+    modDepth = Effect->Reverb.ModulationDepth;
+    if(size.Mod < Effect->Reverb.ModulationTime * modDepth *
+                  MODULATION_DEPTH_COEFF / 2.0f)
+        modDepth = size.Mod * 2.0f / (MODULATION_DEPTH_COEFF *
+                                      Effect->Reverb.ModulationTime);
 
     // Calculate the master low-pass filter (from the master effect HF gain).
     cw = CalcI3DL2HFreq(Effect->Reverb.HFReference, frequency);
@@ -1118,18 +1509,17 @@ static ALvoid EAXVerbUpdate(ALeffectState *effect, ALCcontext *Context, const AL
 
     // Update the modulator line.
     UpdateModulator(Effect->Reverb.ModulationTime,
-                    Effect->Reverb.ModulationDepth, frequency, State);
+                    modDepth, frequency, State);
 
     // Update the initial effect delay.
-    UpdateDelayLine(Effect->Reverb.ReflectionsDelay,
-                    Effect->Reverb.LateReverbDelay, frequency, State);
+    UpdateDelayLine(earlyDelay, lateDelay, frequency, State);
 
     // Update the early lines.
     UpdateEarlyLines(Effect->Reverb.Gain, Effect->Reverb.ReflectionsGain,
                      Effect->Reverb.LateReverbDelay, State);
 
     // Update the decorrelator.
-    UpdateDecorrelator(Effect->Reverb.Density, frequency, State);
+    UpdateDecorrelator(size.Density, frequency, State);
 
     // Get the mixing matrix coefficients (x and y).
     CalcMatrixCoeffs(Effect->Reverb.Diffusion, &x, &y);
@@ -1145,12 +1535,12 @@ static ALvoid EAXVerbUpdate(ALeffectState *effect, ALCcontext *Context, const AL
 
     // Update the late lines.
     UpdateLateLines(Effect->Reverb.Gain, Effect->Reverb.LateReverbGain,
-                    x, Effect->Reverb.Density, Effect->Reverb.DecayTime,
+                    x, size.Density, Effect->Reverb.DecayTime,
                     Effect->Reverb.Diffusion, hfRatio, cw, frequency, State);
 
     // Update the echo line.
     UpdateEchoLine(Effect->Reverb.Gain, Effect->Reverb.LateReverbGain,
-                   Effect->Reverb.EchoTime, Effect->Reverb.DecayTime,
+                   size.Echo, Effect->Reverb.DecayTime,
                    Effect->Reverb.Diffusion, Effect->Reverb.EchoDepth,
                    hfRatio, cw, frequency, State);
 
@@ -1164,31 +1554,36 @@ static ALvoid EAXVerbUpdate(ALeffectState *effect, ALCcontext *Context, const AL
 static ALvoid VerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[MAXCHANNELS])
 {
     ALverbState *State = (ALverbState*)effect;
-    ALuint index;
-    ALfloat early[4], late[4], out[4];
+    ALuint base, index, todo;
+    ALfloat out[4];
     ALfloat gain = Slot->Gain;
     const ALfloat *panGain = State->Gain;
 
-    for(index = 0;index < SamplesToDo;index++)
+    for(base = 0;base < SamplesToDo;base += todo)
     {
-        // Process reverb for this sample.
-        VerbPass(State, SamplesIn[index], early, late);
-
-        // Mix early reflections and late reverb.
-        out[0] = (early[0] + late[0]) * gain;
-        out[1] = (early[1] + late[1]) * gain;
-        out[2] = (early[2] + late[2]) * gain;
-        out[3] = (early[3] + late[3]) * gain;
-
-        // Output the results.
-        SamplesOut[index][FRONT_LEFT]   += panGain[FRONT_LEFT]   * out[0];
-        SamplesOut[index][FRONT_RIGHT]  += panGain[FRONT_RIGHT]  * out[1];
-        SamplesOut[index][FRONT_CENTER] += panGain[FRONT_CENTER] * out[3];
-        SamplesOut[index][SIDE_LEFT]    += panGain[SIDE_LEFT]    * out[0];
-        SamplesOut[index][SIDE_RIGHT]   += panGain[SIDE_RIGHT]   * out[1];
-        SamplesOut[index][BACK_LEFT]    += panGain[BACK_LEFT]    * out[0];
-        SamplesOut[index][BACK_RIGHT]   += panGain[BACK_RIGHT]   * out[1];
-        SamplesOut[index][BACK_CENTER]  += panGain[BACK_CENTER]  * out[2];
+        todo = __min(SamplesToDo-base, CalcBlockLength(State, AL_FALSE));
+
+        // Process reverb for this block.
+        VerbPass(State, &SamplesIn[base], todo);
+
+        for(index = 0;index < todo;index++)
+        {
+            // Mix early reflections and late reverb.
+            out[0] = (State->EarlyOut[index][0] + State->LateOut[index][0]) * gain;
+            out[1] = (State->EarlyOut[index][1] + State->LateOut[index][1]) * gain;
+            out[2] = (State->EarlyOut[index][2] + State->LateOut[index][2]) * gain;
+            out[3] = (State->EarlyOut[index][3] + State->LateOut[index][3]) * gain;
+
+            // Output the results.
+            SamplesOut[base+index][FRONT_LEFT]   += panGain[FRONT_LEFT]   * out[0];
+            SamplesOut[base+index][FRONT_RIGHT]  += panGain[FRONT_RIGHT]  * out[1];
+            SamplesOut[base+index][FRONT_CENTER] += panGain[FRONT_CENTER] * out[3];
+            SamplesOut[base+index][SIDE_LEFT]    += panGain[SIDE_LEFT]    * out[0];
+            SamplesOut[base+index][SIDE_RIGHT]   += panGain[SIDE_RIGHT]   * out[1];
+            SamplesOut[base+index][BACK_LEFT]    += panGain[BACK_LEFT]    * out[0];
+            SamplesOut[base+index][BACK_RIGHT]   += panGain[BACK_RIGHT]   * out[1];
+            SamplesOut[base+index][BACK_CENTER]  += panGain[BACK_CENTER]  * out[2];
+        }
     }
 }
 
@@ -1197,42 +1592,52 @@ static ALvoid VerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuin
 static ALvoid EAXVerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[MAXCHANNELS])
 {
     ALverbState *State = (ALverbState*)effect;
-    ALuint index;
-    ALfloat early[4], late[4];
+    ALuint base, index, todo;
     ALfloat gain = Slot->Gain;
+    const ALfloat *earlyGain = State->Early.PanGain;
+    const ALfloat *lateGain = State->Late.PanGain;
 
-    for(index = 0;index < SamplesToDo;index++)
+    for(base = 0;base < SamplesToDo;base += todo)
     {
-        // Process reverb for this sample.
-        EAXVerbPass(State, SamplesIn[index], early, late);
+        ALfloat (*early)[4] = State->EarlyOut;
+        ALfloat (*late)[4] = State->LateOut;
+        ALfloat (*out)[MAXCHANNELS] = &SamplesOut[base];
+
+        todo = __min(SamplesToDo-base, CalcBlockLength(State, AL_TRUE));
+
+        // Process reverb for this block.
+        EAXVerbPass(State, &SamplesIn[base], todo);
 
         // Unfortunately, while the number and configuration of gains for
         // panning adjust according to MAXCHANNELS, the output from the
         // reverb engine is not so scalable.
-        SamplesOut[index][FRONT_LEFT] +=
-           (State->Early.PanGain[FRONT_LEFT]*early[0] +
-            State->Late.PanGain[FRONT_LEFT]*late[0]) * gain;
-        SamplesOut[index][FRONT_RIGHT] +=
-           (State->Early.PanGain[FRONT_RIGHT]*early[1] +
-            State->Late.PanGain[FRONT_RIGHT]*late[1]) * gain;
-        SamplesOut[index][FRONT_CENTER] +=
-           (State->Early.PanGain[FRONT_CENTER]*early[3] +
-            State->Late.PanGain[FRONT_CENTER]*late[3]) * gain;
-        SamplesOut[index][SIDE_LEFT] +=
-           (State->Early.PanGain[SIDE_LEFT]*early[0] +
-            State->Late.PanGain[SIDE_LEFT]*late[0]) * gain;
-        SamplesOut[index][SIDE_RIGHT] +=
-           (State->Early.PanGain[SIDE_RIGHT]*early[1] +
-            State->Late.PanGain[SIDE_RIGHT]*late[1]) * gain;
-        SamplesOut[index][BACK_LEFT] +=
-           (State->Early.PanGain[BACK_LEFT]*early[0] +
-            State->Late.PanGain[BACK_LEFT]*late[0]) * gain;
-        SamplesOut[index][BACK_RIGHT] +=
-           (State->Early.PanGain[BACK_RIGHT]*early[1] +
-            State->Late.PanGain[BACK_RIGHT]*late[1]) * gain;
-        SamplesOut[index][BACK_CENTER] +=
-           (State->Early.PanGain[BACK_CENTER]*early[2] +
-            State->Late.PanGain[BACK_CENTER]*late[2]) * gain;
+        for(index = 0;index < todo;index++)
+        {
+            out[index][FRONT_LEFT] +=
+               (earlyGain[FRONT_LEFT]*early[index][0] +
+                lateGain[FRONT_LEFT]*late[index][0]) * gain;
+            out[index][FRONT_RIGHT] +=
+               (earlyGain[FRONT_RIGHT]*early[index][1] +
+                lateGain[FRONT_RIGHT]*late[index][1]) * gain;
+            out[index][FRONT_CENTER] +=
+               (earlyGain[FRONT_CENTER]*early[index][3] +
+                lateGain[FRONT_CENTER]*late[index][3]) * gain;
+            out[index][SIDE_LEFT] +=
+               (earlyGain[SIDE_LEFT]*early[index][0] +
+                lateGain[SIDE_LEFT]*late[index][0]) * gain;
+            out[index][SIDE_RIGHT] +=
+               (earlyGain[SIDE_RIGHT]*early[index][1] +
+                lateGain[SIDE_RIGHT]*late[index][1]) * gain;
+            out[index][BACK_LEFT] +=
+               (earlyGain[BACK_LEFT]*early[index][0] +
+                lateGain[BACK_LEFT]*late[index][0]) * gain;
+            out[index][BACK_RIGHT] +=
+               (earlyGain[BACK_RIGHT]*early[index][1] +
+                lateGain[BACK_RIGHT]*late[index][1]) * gain;
+            out[index][BACK_CENTER] +=
+               (earlyGain[BACK_CENTER]*early[index][2] +
+                lateGain[BACK_CENTER]*late[index][2]) * gain;
+        }
     }
 }
 
@@ -1252,8 +1657,13 @@ ALeffectState *VerbCreate(void)
     State->state.Update = VerbUpdate;
     State->state.Process = VerbProcess;
 
+    State->Device = NULL;
     State->TotalSamples = 0;
     State->SampleBuffer = NULL;
+    State->LineSize.Mod = 0.0f;
+    State->LineSize.Delay = 0.0f;
+    State->LineSize.Density = 0.0f;
+    State->LineSize.Echo = 0.0f;
 
     State->LpFilter.coeff = 0.0f;
     State->LpFilter.history[0] = 0.0f;
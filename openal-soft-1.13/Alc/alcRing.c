@@ -129,3 +129,130 @@ void ReadRingBuffer(RingBuffer *ring, ALubyte *data, ALsizei len)
 
     LeaveCriticalSection(&ring->cs);
 }
+
+
+#ifdef HAVE_ATOMIC_OPS
+
+/* A ring buffer for one writer thread and one reader thread, which don't need
+ * to lock each other out. Each side only ever moves its own position, and
+ * publishes it with a store-release after touching the samples, so the other
+ * side never sees the position move before the samples are there. The
+ * positions run freely and are masked into the power-of-2 sized buffer, so
+ * the whole buffer is usable.
+ */
+struct LockFreeRing {
+    ALubyte *mem;
+
+    ALsizei frame_size;
+    ALuint length;
+    volatile ALuint read_pos;
+    volatile ALuint write_pos;
+};
+
+
+LockFreeRing *CreateLockFreeRing(ALsizei frame_size, ALsizei length)
+{
+    LockFreeRing *ring = calloc(1, sizeof(*ring));
+    if(ring)
+    {
+        ring->frame_size = frame_size;
+        ring->length = NextPowerOf2(length);
+        ring->mem = calloc(ring->length, ring->frame_size);
+        if(!ring->mem)
+        {
+            free(ring);
+            ring = NULL;
+        }
+    }
+    return ring;
+}
+
+void DestroyLockFreeRing(LockFreeRing *ring)
+{
+    if(ring)
+    {
+        free(ring->mem);
+        free(ring);
+    }
+}
+
+/* Only safe when neither side is using the ring */
+void ResetLockFreeRing(LockFreeRing *ring)
+{
+    ring->read_pos = 0;
+    ring->write_pos = 0;
+}
+
+/* Either side may check either space, so both positions are loaded with
+ * acquire semantics. */
+ALsizei LockFreeRingReadSpace(LockFreeRing *ring)
+{
+    ALuint read_pos = LoadAcquire(&ring->read_pos);
+    return LoadAcquire(&ring->write_pos) - read_pos;
+}
+
+ALsizei LockFreeRingWriteSpace(LockFreeRing *ring)
+{
+    ALuint write_pos = LoadAcquire(&ring->write_pos);
+    return ring->length - (write_pos - LoadAcquire(&ring->read_pos));
+}
+
+/* Returns where the writer can write next, and in len, how many frames it can
+ * write there without wrapping. Writes are published with
+ * LockFreeRingWriteAdvance. */
+ALubyte *GetLockFreeRingWritePtr(LockFreeRing *ring, ALsizei *len)
+{
+    ALuint pos = ring->write_pos & (ring->length-1);
+    ALsizei space = LockFreeRingWriteSpace(ring);
+
+    *len = min(space, (ALsizei)(ring->length - pos));
+    return ring->mem + pos*ring->frame_size;
+}
+
+void LockFreeRingWriteAdvance(LockFreeRing *ring, ALsizei len)
+{
+    StoreRelease(&ring->write_pos, ring->write_pos + len);
+}
+
+/* Returns where the reader can read next, and in len, how many frames it can
+ * read there without wrapping. The frames stay valid until they're released
+ * with LockFreeRingReadAdvance. */
+ALubyte *GetLockFreeRingReadPtr(LockFreeRing *ring, ALsizei *len)
+{
+    ALuint pos = ring->read_pos & (ring->length-1);
+    ALsizei space = LockFreeRingReadSpace(ring);
+
+    *len = min(space, (ALsizei)(ring->length - pos));
+    return ring->mem + pos*ring->frame_size;
+}
+
+void LockFreeRingReadAdvance(LockFreeRing *ring, ALsizei len)
+{
+    StoreRelease(&ring->read_pos, ring->read_pos + len);
+}
+
+/* Reads up to len frames, returning how many were read */
+ALsizei ReadLockFreeRing(LockFreeRing *ring, ALubyte *data, ALsizei len)
+{
+    ALuint pos = ring->read_pos & (ring->length-1);
+    ALsizei space = LockFreeRingReadSpace(ring);
+    ALsizei remain;
+
+    len = min(len, space);
+    if(len > 0)
+    {
+        remain = ring->length - pos;
+        if(remain < len)
+        {
+            memcpy(data, ring->mem+(pos*ring->frame_size), remain*ring->frame_size);
+            memcpy(data+(remain*ring->frame_size), ring->mem, (len-remain)*ring->frame_size);
+        }
+        else
+            memcpy(data, ring->mem+(pos*ring->frame_size), len*ring->frame_size);
+
+        StoreRelease(&ring->read_pos, ring->read_pos + len);
+    }
+    return len;
+}
+
+#endif
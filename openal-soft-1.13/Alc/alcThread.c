@@ -78,6 +78,27 @@ ALuint StopThread(ALvoid *thread)
     return (ALuint)ret;
 }
 
+
+ALvoid *CreateSem(ALuint count)
+{
+    return CreateSemaphore(NULL, count, 0x7fffffff, NULL);
+}
+
+ALvoid PostSem(ALvoid *sem)
+{
+    ReleaseSemaphore(sem, 1, NULL);
+}
+
+ALvoid WaitSem(ALvoid *sem)
+{
+    WaitForSingleObject(sem, INFINITE);
+}
+
+ALvoid DestroySem(ALvoid *sem)
+{
+    CloseHandle(sem);
+}
+
 #else
 
 #include <pthread.h>
@@ -125,4 +146,92 @@ ALuint StopThread(ALvoid *thread)
     return ret;
 }
 
+
+#if defined(HAVE_S3E_SOUND)
+
+/* Marmalade provides its own semaphores, which are safer to rely on than its
+ * pthread_mutex/pthread_cond (see the note on CRITICAL_SECTION) */
+ALvoid *CreateSem(ALuint count)
+{
+    return s3eThreadSemCreate(count);
+}
+
+ALvoid PostSem(ALvoid *sem)
+{
+    s3eThreadSemPost((s3eThreadSem*)sem);
+}
+
+ALvoid WaitSem(ALvoid *sem)
+{
+    s3eThreadSemWait((s3eThreadSem*)sem, -1);
+}
+
+ALvoid DestroySem(ALvoid *sem)
+{
+    s3eThreadSemDestroy((s3eThreadSem*)sem);
+}
+
+#else
+
+/* Unnamed POSIX semaphores aren't available everywhere (e.g. OSX), so build a
+ * counting semaphore from a mutex and condition variable */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    ALuint count;
+} SemInfo;
+
+ALvoid *CreateSem(ALuint count)
+{
+    SemInfo *inf = malloc(sizeof(SemInfo));
+    if(!inf) return NULL;
+
+    if(pthread_mutex_init(&inf->mutex, NULL) != 0)
+    {
+        free(inf);
+        return NULL;
+    }
+    if(pthread_cond_init(&inf->cond, NULL) != 0)
+    {
+        pthread_mutex_destroy(&inf->mutex);
+        free(inf);
+        return NULL;
+    }
+    inf->count = count;
+
+    return inf;
+}
+
+ALvoid PostSem(ALvoid *sem)
+{
+    SemInfo *inf = sem;
+
+    pthread_mutex_lock(&inf->mutex);
+    inf->count++;
+    pthread_cond_signal(&inf->cond);
+    pthread_mutex_unlock(&inf->mutex);
+}
+
+ALvoid WaitSem(ALvoid *sem)
+{
+    SemInfo *inf = sem;
+
+    pthread_mutex_lock(&inf->mutex);
+    while(inf->count == 0)
+        pthread_cond_wait(&inf->cond, &inf->mutex);
+    inf->count--;
+    pthread_mutex_unlock(&inf->mutex);
+}
+
+ALvoid DestroySem(ALvoid *sem)
+{
+    SemInfo *inf = sem;
+
+    pthread_cond_destroy(&inf->cond);
+    pthread_mutex_destroy(&inf->mutex);
+    free(inf);
+}
+
+#endif
+
 #endif
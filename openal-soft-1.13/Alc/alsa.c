@@ -349,6 +349,8 @@ static ALuint ALSAProc(ALvoid *ptr)
             aluHandleDisconnect(pDevice);
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+            aluDeviceUnderrun(pDevice);
 
         avail = psnd_pcm_avail_update(data->pcmHandle);
         if(avail < 0)
@@ -374,6 +376,8 @@ static ALuint ALSAProc(ALvoid *ptr)
             continue;
         }
         avail -= avail%pDevice->UpdateSize;
+        aluDeviceCallback(pDevice, avail, 0,
+                          pDevice->UpdateSize*pDevice->NumUpdates);
 
         // it is possible that contiguous areas are smaller, thus we use a loop
         while(avail > 0)
@@ -423,10 +427,14 @@ static ALuint ALSANoMMapProc(ALvoid *ptr)
             aluHandleDisconnect(pDevice);
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+            aluDeviceUnderrun(pDevice);
 
         WritePtr = data->buffer;
         avail = data->size / psnd_pcm_frames_to_bytes(data->pcmHandle, 1);
         aluMixData(pDevice, WritePtr, avail);
+        aluDeviceCallback(pDevice, avail, 0,
+                          pDevice->UpdateSize*pDevice->NumUpdates);
 
         while(avail > 0)
         {
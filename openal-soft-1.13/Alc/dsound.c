@@ -216,6 +216,8 @@ static ALuint DSoundProc(ALvoid *ptr)
             continue;
         }
         avail -= avail%FragSize;
+        aluDeviceCallback(pDevice, avail/FrameSize, 0,
+                          DSBCaps.dwBufferBytes/FrameSize);
 
         // Lock output buffer
         WriteCnt1 = 0;
@@ -63,8 +63,46 @@ static __inline ALdouble cubic8(const ALubyte *vals, ALint step, ALint frac)
                 frac * (1.0/FRACTIONONE))-128.0) * (1.0/127.0); }
 
 
-#define DECL_TEMPLATE(T, sampler)                                             \
-static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
+/* Filter stages for each filter type, taking the low-pass and the low-shelf
+ * with their history offsets. Sources only using a low-pass (the common case)
+ * never touch the shelf, and high-pass sources skip the low-pass. */
+#define DECL_TEMPLATE(order)                                                  \
+static __inline ALfloat lp##order(FILTER *hf, FILTER *lf, ALfloat scale,      \
+  ALuint offset, ALuint lfoffset, ALfloat input)                              \
+{ return lpFilter##order(hf, offset, input);                                  \
+  (void)lf; (void)scale; (void)lfoffset; }                                    \
+static __inline ALfloat hp##order(FILTER *hf, FILTER *lf, ALfloat scale,      \
+  ALuint offset, ALuint lfoffset, ALfloat input)                              \
+{ return hpFilter1P(lf, scale, lfoffset, input);                              \
+  (void)hf; (void)offset; }                                                   \
+static __inline ALfloat bp##order(FILTER *hf, FILTER *lf, ALfloat scale,      \
+  ALuint offset, ALuint lfoffset, ALfloat input)                              \
+{ return hpFilter1P(lf, scale, lfoffset,                                      \
+                    lpFilter##order(hf, offset, input)); }                    \
+                                                                              \
+static __inline ALfloat lp##order##C(FILTER *hf, FILTER *lf, ALfloat scale,   \
+  ALuint offset, ALuint lfoffset, ALfloat input)                              \
+{ return lpFilter##order##C(hf, offset, input);                               \
+  (void)lf; (void)scale; (void)lfoffset; }                                    \
+static __inline ALfloat hp##order##C(FILTER *hf, FILTER *lf, ALfloat scale,   \
+  ALuint offset, ALuint lfoffset, ALfloat input)                              \
+{ return hpFilter1PC(lf, scale, lfoffset, input);                             \
+  (void)hf; (void)offset; }                                                   \
+static __inline ALfloat bp##order##C(FILTER *hf, FILTER *lf, ALfloat scale,   \
+  ALuint offset, ALuint lfoffset, ALfloat input)                              \
+{ return hpFilter1PC(lf, scale, lfoffset,                                     \
+                     lpFilter##order##C(hf, offset, input)); }
+
+DECL_TEMPLATE(4P)
+DECL_TEMPLATE(2P)
+DECL_TEMPLATE(1P)
+
+#undef DECL_TEMPLATE
+
+
+#define DECL_TEMPLATE(T, sampler, filter)                                     \
+static void Mix_##T##_1_##sampler##_##filter(ALsource *Source,                \
+  ALCdevice *Device,                                                          \
   const T *data, ALuint *DataPosInt, ALuint *DataPosFrac,                     \
   ALuint OutPos, ALuint SamplesToDo, ALuint BufferSize)                       \
 {                                                                             \
@@ -72,7 +110,8 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
     ALfloat *ClickRemoval, *PendingClicks;                                    \
     ALuint pos, frac;                                                         \
     ALfloat DrySend[MAXCHANNELS];                                             \
-    FILTER *DryFilter;                                                        \
+    FILTER *DryFilter, *DryLfFilter;                                          \
+    ALfloat DryLfScale;                                                       \
     ALuint BufferIdx;                                                         \
     ALuint increment;                                                         \
     ALuint out, c;                                                            \
@@ -84,6 +123,8 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
     ClickRemoval = Device->ClickRemoval;                                      \
     PendingClicks = Device->PendingClicks;                                    \
     DryFilter = &Source->Params.iirFilter;                                    \
+    DryLfFilter = &Source->Params.lfFilter;                                   \
+    DryLfScale = Source->Params.lfScale;                                      \
     for(c = 0;c < MAXCHANNELS;c++)                                            \
         DrySend[c] = Source->Params.DryGains[0][c];                           \
                                                                               \
@@ -94,7 +135,7 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
     {                                                                         \
         value = sampler(data+pos, 1, frac);                                   \
                                                                               \
-        value = lpFilter4PC(DryFilter, 0, value);                             \
+        value = filter##4PC(DryFilter, DryLfFilter, DryLfScale, 0, 0, value); \
         for(c = 0;c < MAXCHANNELS;c++)                                        \
             ClickRemoval[c] -= value*DrySend[c];                              \
     }                                                                         \
@@ -104,7 +145,7 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
         value = sampler(data+pos, 1, frac);                                   \
                                                                               \
         /* Direct path final mix buffer and panning */                        \
-        value = lpFilter4P(DryFilter, 0, value);                              \
+        value = filter##4P(DryFilter, DryLfFilter, DryLfScale, 0, 0, value);  \
         for(c = 0;c < MAXCHANNELS;c++)                                        \
             DryBuffer[OutPos][c] += value*DrySend[c];                         \
                                                                               \
@@ -117,7 +158,7 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
     {                                                                         \
         value = sampler(data+pos, 1, frac);                                   \
                                                                               \
-        value = lpFilter4PC(DryFilter, 0, value);                             \
+        value = filter##4PC(DryFilter, DryLfFilter, DryLfScale, 0, 0, value); \
         for(c = 0;c < MAXCHANNELS;c++)                                        \
             PendingClicks[c] += value*DrySend[c];                             \
     }                                                                         \
@@ -128,7 +169,8 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
         ALfloat *WetBuffer;                                                   \
         ALfloat *WetClickRemoval;                                             \
         ALfloat *WetPendingClicks;                                            \
-        FILTER  *WetFilter;                                                   \
+        FILTER  *WetFilter, *WetLfFilter;                                     \
+        ALfloat  WetLfScale;                                                  \
                                                                               \
         if(!Source->Send[out].Slot ||                                         \
            Source->Send[out].Slot->effect.type == AL_EFFECT_NULL)             \
@@ -138,6 +180,8 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
         WetClickRemoval = Source->Send[out].Slot->ClickRemoval;               \
         WetPendingClicks = Source->Send[out].Slot->PendingClicks;             \
         WetFilter = &Source->Params.Send[out].iirFilter;                      \
+        WetLfFilter = &Source->Params.Send[out].lfFilter;                     \
+        WetLfScale = Source->Params.Send[out].lfScale;                        \
         WetSend = Source->Params.Send[out].WetGain;                           \
                                                                               \
         pos = 0;                                                              \
@@ -148,7 +192,8 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
         {                                                                     \
             value = sampler(data+pos, 1, frac);                               \
                                                                               \
-            value = lpFilter2PC(WetFilter, 0, value);                         \
+            value = filter##2PC(WetFilter, WetLfFilter, WetLfScale,           \
+                                0, 0, value);                                 \
             WetClickRemoval[0] -= value*WetSend;                              \
         }                                                                     \
         for(BufferIdx = 0;BufferIdx < BufferSize;BufferIdx++)                 \
@@ -157,7 +202,8 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
             value = sampler(data+pos, 1, frac);                               \
                                                                               \
             /* Room path final mix buffer and panning */                      \
-            value = lpFilter2P(WetFilter, 0, value);                          \
+            value = filter##2P(WetFilter, WetLfFilter, WetLfScale,            \
+                               0, 0, value);                                  \
             WetBuffer[OutPos] += value*WetSend;                               \
                                                                               \
             frac += increment;                                                \
@@ -169,7 +215,8 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
         {                                                                     \
             value = sampler(data+pos, 1, frac);                               \
                                                                               \
-            value = lpFilter2PC(WetFilter, 0, value);                         \
+            value = filter##2PC(WetFilter, WetLfFilter, WetLfScale,           \
+                                0, 0, value);                                 \
             WetPendingClicks[0] += value*WetSend;                             \
         }                                                                     \
     }                                                                         \
@@ -177,23 +224,42 @@ static void Mix_##T##_1_##sampler(ALsource *Source, ALCdevice *Device,        \
     *DataPosFrac = frac;                                                      \
 }
 
-DECL_TEMPLATE(ALfloat, point32)
-DECL_TEMPLATE(ALfloat, lerp32)
-DECL_TEMPLATE(ALfloat, cubic32)
-
-DECL_TEMPLATE(ALshort, point16)
-DECL_TEMPLATE(ALshort, lerp16)
-DECL_TEMPLATE(ALshort, cubic16)
-
-DECL_TEMPLATE(ALubyte, point8)
-DECL_TEMPLATE(ALubyte, lerp8)
-DECL_TEMPLATE(ALubyte, cubic8)
+DECL_TEMPLATE(ALfloat, point32, lp)
+DECL_TEMPLATE(ALfloat, point32, hp)
+DECL_TEMPLATE(ALfloat, point32, bp)
+DECL_TEMPLATE(ALfloat, lerp32, lp)
+DECL_TEMPLATE(ALfloat, lerp32, hp)
+DECL_TEMPLATE(ALfloat, lerp32, bp)
+DECL_TEMPLATE(ALfloat, cubic32, lp)
+DECL_TEMPLATE(ALfloat, cubic32, hp)
+DECL_TEMPLATE(ALfloat, cubic32, bp)
+
+DECL_TEMPLATE(ALshort, point16, lp)
+DECL_TEMPLATE(ALshort, point16, hp)
+DECL_TEMPLATE(ALshort, point16, bp)
+DECL_TEMPLATE(ALshort, lerp16, lp)
+DECL_TEMPLATE(ALshort, lerp16, hp)
+DECL_TEMPLATE(ALshort, lerp16, bp)
+DECL_TEMPLATE(ALshort, cubic16, lp)
+DECL_TEMPLATE(ALshort, cubic16, hp)
+DECL_TEMPLATE(ALshort, cubic16, bp)
+
+DECL_TEMPLATE(ALubyte, point8, lp)
+DECL_TEMPLATE(ALubyte, point8, hp)
+DECL_TEMPLATE(ALubyte, point8, bp)
+DECL_TEMPLATE(ALubyte, lerp8, lp)
+DECL_TEMPLATE(ALubyte, lerp8, hp)
+DECL_TEMPLATE(ALubyte, lerp8, bp)
+DECL_TEMPLATE(ALubyte, cubic8, lp)
+DECL_TEMPLATE(ALubyte, cubic8, hp)
+DECL_TEMPLATE(ALubyte, cubic8, bp)
 
 #undef DECL_TEMPLATE
 
 
-#define DECL_TEMPLATE(T, chnct, sampler)                                      \
-static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
+#define DECL_TEMPLATE(T, chnct, sampler, filter)                              \
+static void Mix_##T##_##chnct##_##sampler##_##filter(ALsource *Source,        \
+  ALCdevice *Device,                                                          \
   const T *data, ALuint *DataPosInt, ALuint *DataPosFrac,                     \
   ALuint OutPos, ALuint SamplesToDo, ALuint BufferSize)                       \
 {                                                                             \
@@ -203,7 +269,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
     ALfloat *ClickRemoval, *PendingClicks;                                    \
     ALuint pos, frac;                                                         \
     ALfloat DrySend[chnct][MAXCHANNELS];                                      \
-    FILTER *DryFilter;                                                        \
+    FILTER *DryFilter, *DryLfFilter;                                          \
+    ALfloat DryLfScale;                                                       \
     ALuint BufferIdx;                                                         \
     ALuint increment;                                                         \
     ALuint i, out, c;                                                         \
@@ -215,6 +282,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
     ClickRemoval = Device->ClickRemoval;                                      \
     PendingClicks = Device->PendingClicks;                                    \
     DryFilter = &Source->Params.iirFilter;                                    \
+    DryLfFilter = &Source->Params.lfFilter;                                   \
+    DryLfScale = Source->Params.lfScale;                                      \
     for(i = 0;i < Channels;i++)                                               \
     {                                                                         \
         for(c = 0;c < MAXCHANNELS;c++)                                        \
@@ -230,7 +299,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
         {                                                                     \
             value = sampler(data + pos*Channels + i, Channels, frac);         \
                                                                               \
-            value = lpFilter2PC(DryFilter, i*2, value);                       \
+            value = filter##2PC(DryFilter, DryLfFilter, DryLfScale,           \
+                                i*2, i, value);                               \
             for(c = 0;c < MAXCHANNELS;c++)                                    \
                 ClickRemoval[c] -= value*DrySend[i][c];                       \
         }                                                                     \
@@ -241,7 +311,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
         {                                                                     \
             value = sampler(data + pos*Channels + i, Channels, frac);         \
                                                                               \
-            value = lpFilter2P(DryFilter, i*2, value);                        \
+            value = filter##2P(DryFilter, DryLfFilter, DryLfScale,            \
+                               i*2, i, value);                                \
             for(c = 0;c < MAXCHANNELS;c++)                                    \
                 DryBuffer[OutPos][c] += value*DrySend[i][c];                  \
         }                                                                     \
@@ -257,7 +328,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
         {                                                                     \
             value = sampler(data + pos*Channels + i, Channels, frac);         \
                                                                               \
-            value = lpFilter2PC(DryFilter, i*2, value);                       \
+            value = filter##2PC(DryFilter, DryLfFilter, DryLfScale,           \
+                                i*2, i, value);                               \
             for(c = 0;c < MAXCHANNELS;c++)                                    \
                 PendingClicks[c] += value*DrySend[i][c];                      \
         }                                                                     \
@@ -269,7 +341,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
         ALfloat *WetBuffer;                                                   \
         ALfloat *WetClickRemoval;                                             \
         ALfloat *WetPendingClicks;                                            \
-        FILTER  *WetFilter;                                                   \
+        FILTER  *WetFilter, *WetLfFilter;                                     \
+        ALfloat  WetLfScale;                                                  \
                                                                               \
         if(!Source->Send[out].Slot ||                                         \
            Source->Send[out].Slot->effect.type == AL_EFFECT_NULL)             \
@@ -279,6 +352,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
         WetClickRemoval = Source->Send[out].Slot->ClickRemoval;               \
         WetPendingClicks = Source->Send[out].Slot->PendingClicks;             \
         WetFilter = &Source->Params.Send[out].iirFilter;                      \
+        WetLfFilter = &Source->Params.Send[out].lfFilter;                     \
+        WetLfScale = Source->Params.Send[out].lfScale;                        \
         WetSend = Source->Params.Send[out].WetGain;                           \
                                                                               \
         pos = 0;                                                              \
@@ -291,7 +366,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
             {                                                                 \
                 value = sampler(data + pos*Channels + i, Channels, frac);     \
                                                                               \
-                value = lpFilter1PC(WetFilter, i, value);                     \
+                value = filter##1PC(WetFilter, WetLfFilter, WetLfScale,       \
+                                    i, i, value);                             \
                 WetClickRemoval[0] -= value*WetSend * scaler;                 \
             }                                                                 \
         }                                                                     \
@@ -301,7 +377,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
             {                                                                 \
                 value = sampler(data + pos*Channels + i, Channels, frac);     \
                                                                               \
-                value = lpFilter1P(WetFilter, i, value);                      \
+                value = filter##1P(WetFilter, WetLfFilter, WetLfScale,        \
+                                   i, i, value);                              \
                 WetBuffer[OutPos] += value*WetSend * scaler;                  \
             }                                                                 \
                                                                               \
@@ -316,7 +393,8 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
             {                                                                 \
                 value = sampler(data + pos*Channels + i, Channels, frac);     \
                                                                               \
-                value = lpFilter1PC(WetFilter, i, value);                     \
+                value = filter##1PC(WetFilter, WetLfFilter, WetLfScale,       \
+                                    i, i, value);                             \
                 WetPendingClicks[0] += value*WetSend * scaler;                \
             }                                                                 \
         }                                                                     \
@@ -325,126 +403,240 @@ static void Mix_##T##_##chnct##_##sampler(ALsource *Source, ALCdevice *Device,\
     *DataPosFrac = frac;                                                      \
 }
 
-DECL_TEMPLATE(ALfloat, 2, point32)
-DECL_TEMPLATE(ALfloat, 2, lerp32)
-DECL_TEMPLATE(ALfloat, 2, cubic32)
-
-DECL_TEMPLATE(ALshort, 2, point16)
-DECL_TEMPLATE(ALshort, 2, lerp16)
-DECL_TEMPLATE(ALshort, 2, cubic16)
-
-DECL_TEMPLATE(ALubyte, 2, point8)
-DECL_TEMPLATE(ALubyte, 2, lerp8)
-DECL_TEMPLATE(ALubyte, 2, cubic8)
-
-
-DECL_TEMPLATE(ALfloat, 4, point32)
-DECL_TEMPLATE(ALfloat, 4, lerp32)
-DECL_TEMPLATE(ALfloat, 4, cubic32)
-
-DECL_TEMPLATE(ALshort, 4, point16)
-DECL_TEMPLATE(ALshort, 4, lerp16)
-DECL_TEMPLATE(ALshort, 4, cubic16)
-
-DECL_TEMPLATE(ALubyte, 4, point8)
-DECL_TEMPLATE(ALubyte, 4, lerp8)
-DECL_TEMPLATE(ALubyte, 4, cubic8)
-
-
-DECL_TEMPLATE(ALfloat, 6, point32)
-DECL_TEMPLATE(ALfloat, 6, lerp32)
-DECL_TEMPLATE(ALfloat, 6, cubic32)
-
-DECL_TEMPLATE(ALshort, 6, point16)
-DECL_TEMPLATE(ALshort, 6, lerp16)
-DECL_TEMPLATE(ALshort, 6, cubic16)
-
-DECL_TEMPLATE(ALubyte, 6, point8)
-DECL_TEMPLATE(ALubyte, 6, lerp8)
-DECL_TEMPLATE(ALubyte, 6, cubic8)
-
-
-DECL_TEMPLATE(ALfloat, 7, point32)
-DECL_TEMPLATE(ALfloat, 7, lerp32)
-DECL_TEMPLATE(ALfloat, 7, cubic32)
-
-DECL_TEMPLATE(ALshort, 7, point16)
-DECL_TEMPLATE(ALshort, 7, lerp16)
-DECL_TEMPLATE(ALshort, 7, cubic16)
-
-DECL_TEMPLATE(ALubyte, 7, point8)
-DECL_TEMPLATE(ALubyte, 7, lerp8)
-DECL_TEMPLATE(ALubyte, 7, cubic8)
-
-
-DECL_TEMPLATE(ALfloat, 8, point32)
-DECL_TEMPLATE(ALfloat, 8, lerp32)
-DECL_TEMPLATE(ALfloat, 8, cubic32)
-
-DECL_TEMPLATE(ALshort, 8, point16)
-DECL_TEMPLATE(ALshort, 8, lerp16)
-DECL_TEMPLATE(ALshort, 8, cubic16)
-
-DECL_TEMPLATE(ALubyte, 8, point8)
-DECL_TEMPLATE(ALubyte, 8, lerp8)
-DECL_TEMPLATE(ALubyte, 8, cubic8)
+DECL_TEMPLATE(ALfloat, 2, point32, lp)
+DECL_TEMPLATE(ALfloat, 2, point32, hp)
+DECL_TEMPLATE(ALfloat, 2, point32, bp)
+DECL_TEMPLATE(ALfloat, 2, lerp32, lp)
+DECL_TEMPLATE(ALfloat, 2, lerp32, hp)
+DECL_TEMPLATE(ALfloat, 2, lerp32, bp)
+DECL_TEMPLATE(ALfloat, 2, cubic32, lp)
+DECL_TEMPLATE(ALfloat, 2, cubic32, hp)
+DECL_TEMPLATE(ALfloat, 2, cubic32, bp)
+
+DECL_TEMPLATE(ALshort, 2, point16, lp)
+DECL_TEMPLATE(ALshort, 2, point16, hp)
+DECL_TEMPLATE(ALshort, 2, point16, bp)
+DECL_TEMPLATE(ALshort, 2, lerp16, lp)
+DECL_TEMPLATE(ALshort, 2, lerp16, hp)
+DECL_TEMPLATE(ALshort, 2, lerp16, bp)
+DECL_TEMPLATE(ALshort, 2, cubic16, lp)
+DECL_TEMPLATE(ALshort, 2, cubic16, hp)
+DECL_TEMPLATE(ALshort, 2, cubic16, bp)
+
+DECL_TEMPLATE(ALubyte, 2, point8, lp)
+DECL_TEMPLATE(ALubyte, 2, point8, hp)
+DECL_TEMPLATE(ALubyte, 2, point8, bp)
+DECL_TEMPLATE(ALubyte, 2, lerp8, lp)
+DECL_TEMPLATE(ALubyte, 2, lerp8, hp)
+DECL_TEMPLATE(ALubyte, 2, lerp8, bp)
+DECL_TEMPLATE(ALubyte, 2, cubic8, lp)
+DECL_TEMPLATE(ALubyte, 2, cubic8, hp)
+DECL_TEMPLATE(ALubyte, 2, cubic8, bp)
+
+
+DECL_TEMPLATE(ALfloat, 4, point32, lp)
+DECL_TEMPLATE(ALfloat, 4, point32, hp)
+DECL_TEMPLATE(ALfloat, 4, point32, bp)
+DECL_TEMPLATE(ALfloat, 4, lerp32, lp)
+DECL_TEMPLATE(ALfloat, 4, lerp32, hp)
+DECL_TEMPLATE(ALfloat, 4, lerp32, bp)
+DECL_TEMPLATE(ALfloat, 4, cubic32, lp)
+DECL_TEMPLATE(ALfloat, 4, cubic32, hp)
+DECL_TEMPLATE(ALfloat, 4, cubic32, bp)
+
+DECL_TEMPLATE(ALshort, 4, point16, lp)
+DECL_TEMPLATE(ALshort, 4, point16, hp)
+DECL_TEMPLATE(ALshort, 4, point16, bp)
+DECL_TEMPLATE(ALshort, 4, lerp16, lp)
+DECL_TEMPLATE(ALshort, 4, lerp16, hp)
+DECL_TEMPLATE(ALshort, 4, lerp16, bp)
+DECL_TEMPLATE(ALshort, 4, cubic16, lp)
+DECL_TEMPLATE(ALshort, 4, cubic16, hp)
+DECL_TEMPLATE(ALshort, 4, cubic16, bp)
+
+DECL_TEMPLATE(ALubyte, 4, point8, lp)
+DECL_TEMPLATE(ALubyte, 4, point8, hp)
+DECL_TEMPLATE(ALubyte, 4, point8, bp)
+DECL_TEMPLATE(ALubyte, 4, lerp8, lp)
+DECL_TEMPLATE(ALubyte, 4, lerp8, hp)
+DECL_TEMPLATE(ALubyte, 4, lerp8, bp)
+DECL_TEMPLATE(ALubyte, 4, cubic8, lp)
+DECL_TEMPLATE(ALubyte, 4, cubic8, hp)
+DECL_TEMPLATE(ALubyte, 4, cubic8, bp)
+
+
+DECL_TEMPLATE(ALfloat, 6, point32, lp)
+DECL_TEMPLATE(ALfloat, 6, point32, hp)
+DECL_TEMPLATE(ALfloat, 6, point32, bp)
+DECL_TEMPLATE(ALfloat, 6, lerp32, lp)
+DECL_TEMPLATE(ALfloat, 6, lerp32, hp)
+DECL_TEMPLATE(ALfloat, 6, lerp32, bp)
+DECL_TEMPLATE(ALfloat, 6, cubic32, lp)
+DECL_TEMPLATE(ALfloat, 6, cubic32, hp)
+DECL_TEMPLATE(ALfloat, 6, cubic32, bp)
+
+DECL_TEMPLATE(ALshort, 6, point16, lp)
+DECL_TEMPLATE(ALshort, 6, point16, hp)
+DECL_TEMPLATE(ALshort, 6, point16, bp)
+DECL_TEMPLATE(ALshort, 6, lerp16, lp)
+DECL_TEMPLATE(ALshort, 6, lerp16, hp)
+DECL_TEMPLATE(ALshort, 6, lerp16, bp)
+DECL_TEMPLATE(ALshort, 6, cubic16, lp)
+DECL_TEMPLATE(ALshort, 6, cubic16, hp)
+DECL_TEMPLATE(ALshort, 6, cubic16, bp)
+
+DECL_TEMPLATE(ALubyte, 6, point8, lp)
+DECL_TEMPLATE(ALubyte, 6, point8, hp)
+DECL_TEMPLATE(ALubyte, 6, point8, bp)
+DECL_TEMPLATE(ALubyte, 6, lerp8, lp)
+DECL_TEMPLATE(ALubyte, 6, lerp8, hp)
+DECL_TEMPLATE(ALubyte, 6, lerp8, bp)
+DECL_TEMPLATE(ALubyte, 6, cubic8, lp)
+DECL_TEMPLATE(ALubyte, 6, cubic8, hp)
+DECL_TEMPLATE(ALubyte, 6, cubic8, bp)
+
+
+DECL_TEMPLATE(ALfloat, 7, point32, lp)
+DECL_TEMPLATE(ALfloat, 7, point32, hp)
+DECL_TEMPLATE(ALfloat, 7, point32, bp)
+DECL_TEMPLATE(ALfloat, 7, lerp32, lp)
+DECL_TEMPLATE(ALfloat, 7, lerp32, hp)
+DECL_TEMPLATE(ALfloat, 7, lerp32, bp)
+DECL_TEMPLATE(ALfloat, 7, cubic32, lp)
+DECL_TEMPLATE(ALfloat, 7, cubic32, hp)
+DECL_TEMPLATE(ALfloat, 7, cubic32, bp)
+
+DECL_TEMPLATE(ALshort, 7, point16, lp)
+DECL_TEMPLATE(ALshort, 7, point16, hp)
+DECL_TEMPLATE(ALshort, 7, point16, bp)
+DECL_TEMPLATE(ALshort, 7, lerp16, lp)
+DECL_TEMPLATE(ALshort, 7, lerp16, hp)
+DECL_TEMPLATE(ALshort, 7, lerp16, bp)
+DECL_TEMPLATE(ALshort, 7, cubic16, lp)
+DECL_TEMPLATE(ALshort, 7, cubic16, hp)
+DECL_TEMPLATE(ALshort, 7, cubic16, bp)
+
+DECL_TEMPLATE(ALubyte, 7, point8, lp)
+DECL_TEMPLATE(ALubyte, 7, point8, hp)
+DECL_TEMPLATE(ALubyte, 7, point8, bp)
+DECL_TEMPLATE(ALubyte, 7, lerp8, lp)
+DECL_TEMPLATE(ALubyte, 7, lerp8, hp)
+DECL_TEMPLATE(ALubyte, 7, lerp8, bp)
+DECL_TEMPLATE(ALubyte, 7, cubic8, lp)
+DECL_TEMPLATE(ALubyte, 7, cubic8, hp)
+DECL_TEMPLATE(ALubyte, 7, cubic8, bp)
+
+
+DECL_TEMPLATE(ALfloat, 8, point32, lp)
+DECL_TEMPLATE(ALfloat, 8, point32, hp)
+DECL_TEMPLATE(ALfloat, 8, point32, bp)
+DECL_TEMPLATE(ALfloat, 8, lerp32, lp)
+DECL_TEMPLATE(ALfloat, 8, lerp32, hp)
+DECL_TEMPLATE(ALfloat, 8, lerp32, bp)
+DECL_TEMPLATE(ALfloat, 8, cubic32, lp)
+DECL_TEMPLATE(ALfloat, 8, cubic32, hp)
+DECL_TEMPLATE(ALfloat, 8, cubic32, bp)
+
+DECL_TEMPLATE(ALshort, 8, point16, lp)
+DECL_TEMPLATE(ALshort, 8, point16, hp)
+DECL_TEMPLATE(ALshort, 8, point16, bp)
+DECL_TEMPLATE(ALshort, 8, lerp16, lp)
+DECL_TEMPLATE(ALshort, 8, lerp16, hp)
+DECL_TEMPLATE(ALshort, 8, lerp16, bp)
+DECL_TEMPLATE(ALshort, 8, cubic16, lp)
+DECL_TEMPLATE(ALshort, 8, cubic16, hp)
+DECL_TEMPLATE(ALshort, 8, cubic16, bp)
+
+DECL_TEMPLATE(ALubyte, 8, point8, lp)
+DECL_TEMPLATE(ALubyte, 8, point8, hp)
+DECL_TEMPLATE(ALubyte, 8, point8, bp)
+DECL_TEMPLATE(ALubyte, 8, lerp8, lp)
+DECL_TEMPLATE(ALubyte, 8, lerp8, hp)
+DECL_TEMPLATE(ALubyte, 8, lerp8, bp)
+DECL_TEMPLATE(ALubyte, 8, cubic8, lp)
+DECL_TEMPLATE(ALubyte, 8, cubic8, hp)
+DECL_TEMPLATE(ALubyte, 8, cubic8, bp)
 
 #undef DECL_TEMPLATE
 
 
-#define DECL_TEMPLATE(T, sampler)                                             \
-static void Mix_##T##_##sampler(ALsource *Source, ALCdevice *Device,          \
-  enum FmtChannels FmtChannels,                                               \
+#define DECL_TEMPLATE(T, sampler, filter)                                     \
+static void Mix_##T##_##sampler##_##filter(ALsource *Source,                  \
+  ALCdevice *Device, enum FmtChannels FmtChannels,                            \
   const ALvoid *Data, ALuint *DataPosInt, ALuint *DataPosFrac,                \
   ALuint OutPos, ALuint SamplesToDo, ALuint BufferSize)                       \
 {                                                                             \
     switch(FmtChannels)                                                       \
     {                                                                         \
     case FmtMono:                                                             \
-        Mix_##T##_1_##sampler(Source, Device, Data, DataPosInt, DataPosFrac,  \
-                              OutPos, SamplesToDo, BufferSize);               \
+        Mix_##T##_1_##sampler##_##filter(Source, Device, Data,                \
+                                         DataPosInt, DataPosFrac,             \
+                                         OutPos, SamplesToDo, BufferSize);    \
         break;                                                                \
     case FmtStereo:                                                           \
     case FmtRear:                                                             \
-        Mix_##T##_2_##sampler(Source, Device, Data, DataPosInt, DataPosFrac,  \
-                              OutPos, SamplesToDo, BufferSize);               \
+        Mix_##T##_2_##sampler##_##filter(Source, Device, Data,                \
+                                         DataPosInt, DataPosFrac,             \
+                                         OutPos, SamplesToDo, BufferSize);    \
         break;                                                                \
     case FmtQuad:                                                             \
-        Mix_##T##_4_##sampler(Source, Device, Data, DataPosInt, DataPosFrac,  \
-                              OutPos, SamplesToDo, BufferSize);               \
+        Mix_##T##_4_##sampler##_##filter(Source, Device, Data,                \
+                                         DataPosInt, DataPosFrac,             \
+                                         OutPos, SamplesToDo, BufferSize);    \
         break;                                                                \
     case FmtX51:                                                              \
-        Mix_##T##_6_##sampler(Source, Device, Data, DataPosInt, DataPosFrac,  \
-                              OutPos, SamplesToDo, BufferSize);               \
+        Mix_##T##_6_##sampler##_##filter(Source, Device, Data,                \
+                                         DataPosInt, DataPosFrac,             \
+                                         OutPos, SamplesToDo, BufferSize);    \
         break;                                                                \
     case FmtX61:                                                              \
-        Mix_##T##_7_##sampler(Source, Device, Data, DataPosInt, DataPosFrac,  \
-                              OutPos, SamplesToDo, BufferSize);               \
+        Mix_##T##_7_##sampler##_##filter(Source, Device, Data,                \
+                                         DataPosInt, DataPosFrac,             \
+                                         OutPos, SamplesToDo, BufferSize);    \
         break;                                                                \
     case FmtX71:                                                              \
-        Mix_##T##_8_##sampler(Source, Device, Data, DataPosInt, DataPosFrac,  \
-                              OutPos, SamplesToDo, BufferSize);               \
+        Mix_##T##_8_##sampler##_##filter(Source, Device, Data,                \
+                                         DataPosInt, DataPosFrac,             \
+                                         OutPos, SamplesToDo, BufferSize);    \
         break;                                                                \
     }                                                                         \
 }
 
-DECL_TEMPLATE(ALfloat, point32)
-DECL_TEMPLATE(ALfloat, lerp32)
-DECL_TEMPLATE(ALfloat, cubic32)
-
-DECL_TEMPLATE(ALshort, point16)
-DECL_TEMPLATE(ALshort, lerp16)
-DECL_TEMPLATE(ALshort, cubic16)
-
-DECL_TEMPLATE(ALubyte, point8)
-DECL_TEMPLATE(ALubyte, lerp8)
-DECL_TEMPLATE(ALubyte, cubic8)
+DECL_TEMPLATE(ALfloat, point32, lp)
+DECL_TEMPLATE(ALfloat, point32, hp)
+DECL_TEMPLATE(ALfloat, point32, bp)
+DECL_TEMPLATE(ALfloat, lerp32, lp)
+DECL_TEMPLATE(ALfloat, lerp32, hp)
+DECL_TEMPLATE(ALfloat, lerp32, bp)
+DECL_TEMPLATE(ALfloat, cubic32, lp)
+DECL_TEMPLATE(ALfloat, cubic32, hp)
+DECL_TEMPLATE(ALfloat, cubic32, bp)
+
+DECL_TEMPLATE(ALshort, point16, lp)
+DECL_TEMPLATE(ALshort, point16, hp)
+DECL_TEMPLATE(ALshort, point16, bp)
+DECL_TEMPLATE(ALshort, lerp16, lp)
+DECL_TEMPLATE(ALshort, lerp16, hp)
+DECL_TEMPLATE(ALshort, lerp16, bp)
+DECL_TEMPLATE(ALshort, cubic16, lp)
+DECL_TEMPLATE(ALshort, cubic16, hp)
+DECL_TEMPLATE(ALshort, cubic16, bp)
+
+DECL_TEMPLATE(ALubyte, point8, lp)
+DECL_TEMPLATE(ALubyte, point8, hp)
+DECL_TEMPLATE(ALubyte, point8, bp)
+DECL_TEMPLATE(ALubyte, lerp8, lp)
+DECL_TEMPLATE(ALubyte, lerp8, hp)
+DECL_TEMPLATE(ALubyte, lerp8, bp)
+DECL_TEMPLATE(ALubyte, cubic8, lp)
+DECL_TEMPLATE(ALubyte, cubic8, hp)
+DECL_TEMPLATE(ALubyte, cubic8, bp)
 
 #undef DECL_TEMPLATE
 
 
-#define DECL_TEMPLATE(sampler)                                                \
-static void Mix_##sampler(ALsource *Source, ALCdevice *Device,                \
+#define DECL_TEMPLATE(sampler, filter)                                        \
+static void Mix_##sampler##_##filter(ALsource *Source, ALCdevice *Device,     \
   enum FmtChannels FmtChannels, enum FmtType FmtType,                         \
   const ALvoid *Data, ALuint *DataPosInt, ALuint *DataPosFrac,                \
   ALuint OutPos, ALuint SamplesToDo, ALuint BufferSize)                       \
@@ -452,21 +644,66 @@ static void Mix_##sampler(ALsource *Source, ALCdevice *Device,                \
     switch(FmtType)                                                           \
     {                                                                         \
     case FmtUByte:                                                            \
-        Mix_ALubyte_##sampler##8(Source, Device, FmtChannels,                 \
-                                 Data, DataPosInt, DataPosFrac,               \
-                                 OutPos, SamplesToDo, BufferSize);            \
+        Mix_ALubyte_##sampler##8##_##filter(Source, Device, FmtChannels,      \
+                                            Data, DataPosInt, DataPosFrac,    \
+                                            OutPos, SamplesToDo, BufferSize); \
         break;                                                                \
                                                                               \
     case FmtShort:                                                            \
-        Mix_ALshort_##sampler##16(Source, Device, FmtChannels,                \
-                                  Data, DataPosInt, DataPosFrac,              \
-                                  OutPos, SamplesToDo, BufferSize);           \
+        Mix_ALshort_##sampler##16##_##filter(Source, Device, FmtChannels,     \
+                                             Data, DataPosInt, DataPosFrac,   \
+                                             OutPos, SamplesToDo, BufferSize);\
         break;                                                                \
                                                                               \
     case FmtFloat:                                                            \
-        Mix_ALfloat_##sampler##32(Source, Device, FmtChannels,                \
-                                  Data, DataPosInt, DataPosFrac,              \
-                                  OutPos, SamplesToDo, BufferSize);           \
+        Mix_ALfloat_##sampler##32##_##filter(Source, Device, FmtChannels,     \
+                                             Data, DataPosInt, DataPosFrac,   \
+                                             OutPos, SamplesToDo, BufferSize);\
+        break;                                                                \
+    }                                                                         \
+}
+
+DECL_TEMPLATE(point, lp)
+DECL_TEMPLATE(point, hp)
+DECL_TEMPLATE(point, bp)
+
+DECL_TEMPLATE(lerp, lp)
+DECL_TEMPLATE(lerp, hp)
+DECL_TEMPLATE(lerp, bp)
+
+DECL_TEMPLATE(cubic, lp)
+DECL_TEMPLATE(cubic, hp)
+DECL_TEMPLATE(cubic, bp)
+
+#undef DECL_TEMPLATE
+
+
+/* Picks the kernel for the filters the source uses, so the extra filter
+ * stages are only run when they're needed. */
+#define DECL_TEMPLATE(sampler)                                                \
+static void Mix_##sampler(ALsource *Source, ALCdevice *Device,                \
+  enum FmtChannels FmtChannels, enum FmtType FmtType,                         \
+  const ALvoid *Data, ALuint *DataPosInt, ALuint *DataPosFrac,                \
+  ALuint OutPos, ALuint SamplesToDo, ALuint BufferSize)                       \
+{                                                                             \
+    switch(Source->Params.FilterType)                                         \
+    {                                                                         \
+    case LOWPASS_FILTER:                                                      \
+        Mix_##sampler##_lp(Source, Device, FmtChannels, FmtType,              \
+                           Data, DataPosInt, DataPosFrac,                     \
+                           OutPos, SamplesToDo, BufferSize);                  \
+        break;                                                                \
+                                                                              \
+    case HIGHPASS_FILTER:                                                     \
+        Mix_##sampler##_hp(Source, Device, FmtChannels, FmtType,              \
+                           Data, DataPosInt, DataPosFrac,                     \
+                           OutPos, SamplesToDo, BufferSize);                  \
+        break;                                                                \
+                                                                              \
+    case BANDPASS_FILTER:                                                     \
+        Mix_##sampler##_bp(Source, Device, FmtChannels, FmtType,              \
+                           Data, DataPosInt, DataPosFrac,                     \
+                           OutPos, SamplesToDo, BufferSize);                  \
         break;                                                                \
     }                                                                         \
 }
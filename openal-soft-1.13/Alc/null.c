@@ -26,17 +26,115 @@
 #include "AL/alc.h"
 
 
+/* Resolution and range of the benchmark's mix time histogram, in
+ * microseconds. Longer updates are counted in the last bucket. */
+#define BENCH_BUCKET_TIME 10
+#define BENCH_BUCKETS     10000
+
 typedef struct {
     ALvoid *buffer;
     ALuint size;
 
     volatile int killNow;
     ALvoid *thread;
+
+    // Mix as fast as possible and measure it, instead of playing in real time
+    ALboolean benchmark;
+    ALuint *benchTimes;
+    ALuint benchMaxTime;
+    ALuint64 benchUpdates;
+    ALuint64 benchMixTime;
+    ALuint64 benchVoices;
+    ALuint benchMaxVoices;
 } null_data;
 
 
 static const ALCchar nullDevice[] = "No Output";
 
+static ALuint CountActiveVoices(ALCdevice *Device)
+{
+    ALuint voices = 0;
+    ALuint i;
+
+    SuspendContext(NULL);
+    for(i = 0;i < Device->NumContexts;i++)
+        voices += Device->Contexts[i]->ActiveSourceCount;
+    ProcessContext(NULL);
+
+    return voices;
+}
+
+static ALuint NullBenchmarkProc(ALvoid *ptr)
+{
+    ALCdevice *Device = (ALCdevice*)ptr;
+    null_data *data = (null_data*)Device->ExtraData;
+    ALuint64 start;
+    ALuint voices, time;
+
+    while(!data->killNow && Device->Connected)
+    {
+        voices = CountActiveVoices(Device);
+
+        start = GetMicroTime();
+        aluMixData(Device, data->buffer, Device->UpdateSize);
+        time = (ALuint)(GetMicroTime() - start);
+
+        /* Leave out updates with nothing playing, such as before the app
+         * starts its sources, so they don't skew the results */
+        if(voices == 0)
+            continue;
+
+        data->benchTimes[min(time/BENCH_BUCKET_TIME, BENCH_BUCKETS-1)]++;
+        data->benchMaxTime = max(data->benchMaxTime, time);
+        data->benchUpdates++;
+        data->benchMixTime += time;
+        data->benchVoices += voices;
+        data->benchMaxVoices = max(data->benchMaxVoices, voices);
+    }
+
+    return 0;
+}
+
+/* Returns the mix time, in microseconds, that the given fraction of updates
+ * finished within */
+static ALuint BenchmarkPercentile(const null_data *data, ALdouble fraction)
+{
+    ALuint64 target, count = 0;
+    ALuint i;
+
+    target = (ALuint64)(data->benchUpdates * fraction);
+    for(i = 0;i < BENCH_BUCKETS-1;i++)
+    {
+        count += data->benchTimes[i];
+        if(count > target)
+            return min((i+1) * BENCH_BUCKET_TIME, data->benchMaxTime);
+    }
+    return data->benchMaxTime;
+}
+
+static void PrintBenchmark(ALCdevice *Device, const null_data *data)
+{
+    ALdouble seconds, fps;
+
+    if(data->benchUpdates == 0 || data->benchMixTime == 0)
+    {
+        AL_PRINT("benchmark: no voices were mixed\n");
+        return;
+    }
+
+    seconds = data->benchMixTime / 1000000.0;
+    fps = (ALdouble)data->benchUpdates * Device->UpdateSize / seconds;
+    AL_PRINT("benchmark: %.0f frames/sec (%.1fx real time) over %.3fs mixing\n",
+             fps, fps / Device->Frequency, seconds);
+    AL_PRINT("benchmark: %u-frame update time (us): 50%%<%u 90%%<%u 99%%<%u 99.9%%<%u max %u\n",
+             Device->UpdateSize, BenchmarkPercentile(data, 0.5),
+             BenchmarkPercentile(data, 0.9), BenchmarkPercentile(data, 0.99),
+             BenchmarkPercentile(data, 0.999), data->benchMaxTime);
+    AL_PRINT("benchmark: voices per update: avg %.1f max %u\n",
+             (ALdouble)data->benchVoices / data->benchUpdates,
+             data->benchMaxVoices);
+}
+
 static ALuint NullProc(ALvoid *ptr)
 {
     ALCdevice *Device = (ALCdevice*)ptr;
@@ -65,11 +163,14 @@ static ALuint NullProc(ALvoid *ptr)
             Sleep(restTime);
             continue;
         }
+        if(avail-done > Device->UpdateSize*Device->NumUpdates)
+            aluDeviceUnderrun(Device);
 
         while(avail-done >= Device->UpdateSize)
         {
             aluMixData(Device, data->buffer, Device->UpdateSize);
             done += Device->UpdateSize;
+            aluDeviceCallback(Device, Device->UpdateSize, 0, Device->UpdateSize);
         }
     }
 
@@ -86,6 +187,7 @@ static ALCboolean null_open_playback(ALCdevice *device, const ALCchar *deviceNam
         return ALC_FALSE;
 
     data = (null_data*)calloc(1, sizeof(*data));
+    data->benchmark = GetConfigValueBool("null", "benchmark", 0);
 
     device->szDeviceName = strdup(deviceName);
     device->ExtraData = data;
@@ -114,9 +216,29 @@ static ALCboolean null_reset_playback(ALCdevice *device)
     }
     SetDefaultWFXChannelOrder(device);
 
-    data->thread = StartThread(NullProc, device);
+    if(data->benchmark)
+    {
+        data->benchTimes = calloc(BENCH_BUCKETS, sizeof(*data->benchTimes));
+        if(!data->benchTimes)
+        {
+            AL_PRINT("benchmark histogram calloc failed\n");
+            free(data->buffer);
+            data->buffer = NULL;
+            return ALC_FALSE;
+        }
+        data->benchMaxTime = 0;
+        data->benchUpdates = 0;
+        data->benchMixTime = 0;
+        data->benchVoices = 0;
+        data->benchMaxVoices = 0;
+    }
+
+    data->thread = StartThread(data->benchmark ? NullBenchmarkProc : NullProc,
+                               device);
     if(data->thread == NULL)
     {
+        free(data->benchTimes);
+        data->benchTimes = NULL;
         free(data->buffer);
         data->buffer = NULL;
         return ALC_FALSE;
@@ -138,6 +260,13 @@ static void null_stop_playback(ALCdevice *device)
 
     data->killNow = 0;
 
+    if(data->benchmark)
+    {
+        PrintBenchmark(device, data);
+        free(data->benchTimes);
+        data->benchTimes = NULL;
+    }
+
     free(data->buffer);
     data->buffer = NULL;
 }
@@ -89,8 +89,21 @@ static ALuint OSSProc(ALvoid *ptr)
     {
         ALint len = data->data_size;
         ALubyte *WritePtr = data->mix_data;
+        ALint queued = pDevice->UpdateSize*pDevice->NumUpdates*frameSize;
+#ifdef SNDCTL_DSP_GETERROR
+        audio_errinfo errinfo;
+
+        if(ioctl(data->fd, SNDCTL_DSP_GETERROR, &errinfo) == 0 &&
+           errinfo.play_underruns > 0)
+            aluDeviceUnderrun(pDevice);
+#endif
+#ifdef SNDCTL_DSP_GETODELAY
+        if(ioctl(data->fd, SNDCTL_DSP_GETODELAY, &queued) != 0)
+            queued = pDevice->UpdateSize*pDevice->NumUpdates*frameSize;
+#endif
 
         aluMixData(pDevice, WritePtr, len/frameSize);
+        aluDeviceCallback(pDevice, len/frameSize, 0, (queued+len)/frameSize);
         while(len > 0 && !data->killNow)
         {
             wrote = write(data->fd, WritePtr, len);
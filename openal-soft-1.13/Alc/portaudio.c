@@ -138,12 +138,20 @@ static int pa_callback(const void *inputBuffer, void *outputBuffer,
                        const PaStreamCallbackFlags statusFlags, void *userData)
 {
     ALCdevice *device = (ALCdevice*)userData;
+    ALuint latency = framesPerBuffer;
 
     (void)inputBuffer;
-    (void)timeInfo;
-    (void)statusFlags;
+
+    if((statusFlags&paOutputUnderflow))
+        aluDeviceUnderrun(device);
+    // Not all host APIs provide timing info
+    if(timeInfo && timeInfo->outputBufferDacTime > timeInfo->currentTime)
+        latency = (ALuint)((timeInfo->outputBufferDacTime -
+                            timeInfo->currentTime) * device->Frequency) +
+                  framesPerBuffer;
 
     aluMixData(device, outputBuffer, framesPerBuffer);
+    aluDeviceCallback(device, framesPerBuffer, 0, latency);
     return 0;
 }
 
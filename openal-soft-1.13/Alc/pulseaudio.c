@@ -306,12 +306,13 @@ static void stream_state_callback(pa_stream *stream, void *pdata) //{{{
         ppa_threaded_mainloop_signal(loop, 0);
 }//}}}
 
-static void stream_signal_callback(pa_stream *stream, void *pdata) //{{{
+static void stream_underflow_callback(pa_stream *stream, void *pdata) //{{{
 {
     ALCdevice *Device = pdata;
     pulse_data *data = Device->ExtraData;
     (void)stream;
 
+    aluDeviceUnderrun(Device);
     ppa_threaded_mainloop_signal(data->loop, 0);
 }//}}}
 
@@ -542,6 +543,8 @@ static ALuint PulseProc(ALvoid *param)
             ppa_threaded_mainloop_wait(data->loop);
             continue;
         }
+        aluDeviceCallback(Device, len/data->frame_size, 0,
+                          data->attr.tlength/data->frame_size);
 
         while(len > 0)
         {
@@ -963,7 +966,7 @@ static ALCboolean pulse_reset_playback(ALCdevice *device) //{{{
 #endif
     ppa_stream_set_moved_callback(data->stream, stream_device_callback, device);
     ppa_stream_set_write_callback(data->stream, stream_write_callback, device);
-    ppa_stream_set_underflow_callback(data->stream, stream_signal_callback, device);
+    ppa_stream_set_underflow_callback(data->stream, stream_underflow_callback, device);
 
     data->thread = StartThread(PulseProc, device);
     if(!data->thread)
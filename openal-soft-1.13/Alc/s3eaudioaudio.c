@@ -195,6 +195,8 @@ static ALuint s3eAudioProc(ALvoid *ptr)
 				dataLength += size;
 			}
 			data->dataLength = dataLength;
+			aluDeviceCallback(pDevice, pDevice->UpdateSize,
+			                  dataLength/frameSize, dataLength/frameSize);
         }
 		// play whatever we've buffered up
 		data->audioReady = 0;
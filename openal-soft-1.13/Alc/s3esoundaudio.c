@@ -2,6 +2,7 @@
 #include "config.h"
 
 #include <malloc.h>
+#include <string.h>
 #include "alMain.h"
 #include "AL/al.h"
 #include "AL/alc.h"
@@ -10,9 +11,21 @@
 #include <s3eDevice.h>
 #include <s3eTimer.h>
 
+// The callback and the mixer thread share the pre-buffer through a lock-free
+// ring. Marmalade's compilers (GCC, MSVC and RVCT for ARMv7) all provide the
+// atomic operations it needs
+#ifndef HAVE_ATOMIC_OPS
+#error "The s3e backend needs the atomic operations in alMain.h"
+#endif
+
 
 static const ALCchar s3eDevice[] = "s3eSound";
 
+// How often the pre-buffer size is reconsidered, in milliseconds, and the
+// most windows to wait before shrinking it after an underrun
+#define ADAPT_WINDOW_MS  2000
+#define MAX_HOLD_WINDOWS 32
+
 typedef struct _s3e_data {
     // s3e sound channel ID
     int                     channel;
@@ -25,17 +38,35 @@ typedef struct _s3e_data {
     int                     bytesPerSample;
     // If true, we're playing stereo sound
     int                     isStereo;
-
-    // Pre-buffer data (cyclic or ring buffer)
-    // Stereo sound - use uint32
-    ALubyte*                preBufferData;
-    // Maximum size of pre-buffer data
-    // (number of int32 for stereo, or int16 for mono sound)
-    int                     preBufferSize;
-    // Pointer where is start of usable data
-    volatile int            preBuffer_DataStartIndex;
-    // How much usable (already mixed) data is in the buffer
-    volatile int            preBuffer_DataEndIndex;
+    // If true, the s3e callback mixes straight into the output, with no
+    // worker thread or pre-buffer
+    int                     directMix;
+
+    // Pre-buffer data, mixed by the worker thread and read by the s3e
+    // callback. Neither side locks, so the callback never waits on the mixer.
+    // It's allocated for the maximum latency
+    LockFreeRing*           preBuffer;
+    // Latency bounds for the pre-buffer, in samples
+    int                     minPreBuffer;
+    int                     maxPreBuffer;
+    // How many samples the worker thread keeps mixed ahead, and the most it
+    // mixes at once. Set by the callback as it measures playback
+    volatile ALuint         preBufferSize;
+    volatile ALuint         mixChunk;
+
+    // Playback measurements, only used by the callback. Over the current
+    // window: the fewest samples left in the pre-buffer after a callback,
+    // and the latest a callback came (in samples)
+    uint64                  lastCallbackTime;
+    int                     windowSamples;
+    int                     lowWater;
+    int                     maxJitter;
+    // Windows without an underrun, and how many are needed before shrinking
+    int                     quietWindows;
+    int                     holdWindows;
+    // Set by the worker thread when the pre-buffer is full and it's about to
+    // wait, so the callback only posts the semaphore when it's needed
+    volatile ALuint         mixerWaiting;
 
     // Pointer to worker thread
     // It has to be volatile, it can change in different threads
@@ -49,19 +80,12 @@ typedef struct _s3e_data {
     volatile int            thread_exited;
 } s3e_data;
 
-int getDataInBuffer( const int startIndex, const int endIndex, const int size )
-{
-    return startIndex <= endIndex   // also if equal - it means 0 length
-        ? endIndex - startIndex
-        : (size - startIndex) + endIndex;
-}
-
-
 static ALuint s3e_channel_thread( ALvoid *ptr )
 {
     ALCdevice *Device = (ALCdevice*)ptr;
     s3e_data *data = (s3e_data*)Device->ExtraData;
-    int startIdx, samplesToMix, len, idx1, len1, len2;
+    int samplesToMix, preBufferSize, len;
+    ALubyte *buffer;
     data->thread_exited = 0;
 
     // This thread will pre-mix sound data into internal buffer
@@ -69,41 +93,39 @@ static ALuint s3e_channel_thread( ALvoid *ptr )
     // copy data from that buffer... And then we get signal
     // to pre-mix some more data for next s3e sound callback.
 
-    // This thread can only modify preBuffer_DataEndIndex and never preBuffer_DataStartIndex
+    // This thread only writes to the pre-buffer, and the callback only reads
     while( !data->killNow && !s3eDeviceCheckQuitRequest() )
     {
-        startIdx = data->preBuffer_DataStartIndex;
-        len = getDataInBuffer( startIdx, data->preBuffer_DataEndIndex, data->preBufferSize );
-        assert( startIdx >= 0 && startIdx < data->preBufferSize );
-        assert( len >= 0 && len < data->preBufferSize );
-
-        // Mix the data in the circular (ring) buffer
-        // Always fill buffer to the max, minus 16 bytes
-        // Those 16 bytes we leave is so startIndex never equals endIndex
-        samplesToMix = min( 2*data->sampleSize, (data->preBufferSize - len) - 16 );
-
-        // Mix data in two steps - first mix from the end of the buffer
-        idx1 = data->preBuffer_DataEndIndex;
-        len1 = min( data->preBufferSize - idx1, samplesToMix );
-        if( len1 > 0 ) aluMixData( Device, data->preBufferData + idx1*data->bytesPerSample, len1 );
-        // Mix 2nd step - from start of the buffer
-        len2 = samplesToMix - len1;
-        if( len2 > 0 ) aluMixData( Device, data->preBufferData, len2 );
-        assert( len2 <= startIdx );
-
-        // Ok, sound data mixed, move endIndex pointer
-        idx1 = data->preBuffer_DataEndIndex + samplesToMix;
-        if( idx1 >= data->preBufferSize ) idx1 -= data->preBufferSize;
-        data->preBuffer_DataEndIndex = idx1;
-
-        // Wait until some of the data in buffer is used
-        // by s3e sound callback
-        while( !data->killNow && s3eThreadSemWait(data->thread_semaphore, 10) != S3E_RESULT_SUCCESS )
+        // Keep the pre-buffer filled, mixing up to mixChunk samples at a time
+        preBufferSize = LoadAcquire( &data->preBufferSize );
+        samplesToMix = preBufferSize - LockFreeRingReadSpace( data->preBuffer );
+        samplesToMix = min( (int)LoadAcquire( &data->mixChunk ), samplesToMix );
+        if( samplesToMix > 0 )
         {
-            // Waited 10ms, but without any signal - just check if we need
-            // to close this thread, and then wait again
-            if( s3eDeviceCheckQuitRequest() ) data->killNow = 1;
+            // Mix straight into the pre-buffer. If it wraps, the rest is
+            // mixed on the next pass
+            buffer = GetLockFreeRingWritePtr( data->preBuffer, &len );
+            len = min( len, samplesToMix );
+            aluMixData( Device, buffer, len );
+            LockFreeRingWriteAdvance( data->preBuffer, len );
+            continue;
         }
+
+        // The pre-buffer is full. Flag that we're waiting, then check again
+        // in case the callback read some data before it could see the flag
+        CompExchangeUInt( &data->mixerWaiting, 0, 1 );
+        if( LockFreeRingReadSpace( data->preBuffer ) >= preBufferSize )
+        {
+            // Wait until some of the data in buffer is used
+            // by s3e sound callback
+            while( !data->killNow && s3eThreadSemWait(data->thread_semaphore, 10) != S3E_RESULT_SUCCESS )
+            {
+                // Waited 10ms, but without any signal - just check if we need
+                // to close this thread, and then wait again
+                if( s3eDeviceCheckQuitRequest() ) data->killNow = 1;
+            }
+        }
+        StoreRelease( &data->mixerWaiting, 0 );
     }
 
     data->thread_exited = 1;
@@ -111,6 +133,71 @@ static ALuint s3e_channel_thread( ALvoid *ptr )
 }
 
 
+static void SetPreBufferSize( s3e_data *data, int size )
+{
+    size = max( size, data->minPreBuffer );
+    size = min( size, data->maxPreBuffer );
+
+    // Mix in steps of 2/3 of the pre-buffer (2 updates for the old fixed size
+    // of 3), so smaller pre-buffers are also topped up sooner
+    StoreRelease( &data->mixChunk, max( size*2/3, 1 ) );
+    StoreRelease( &data->preBufferSize, size );
+}
+
+static void ResetPlaybackWindow( s3e_data *data )
+{
+    data->windowSamples = 0;
+    data->lowWater = data->maxPreBuffer;
+    data->maxJitter = 0;
+}
+
+// Measures how close this callback came to running out of data, and adjusts
+// the pre-buffer size. It grows by a callback's worth as soon as a callback
+// runs short. After enough windows without underruns, it shrinks by half of
+// the smallest margin seen, but stays large enough to cover a callback
+// arriving as late as the latest one in the window. Each underrun doubles the
+// number of windows needed, so a device that stalls now and then settles on a
+// size that covers the stalls instead of shrinking back between them.
+static void UpdatePreBufferSize( ALCdevice *device, s3e_data *data, int available, int numSamples )
+{
+    uint64 now = s3eTimerGetUST();
+    int size = LoadAcquire( &data->preBufferSize );
+    int expected, late, needed;
+
+    if( data->lastCallbackTime != 0 )
+    {
+        // How much later than one callback's worth of time this one came
+        expected = numSamples * 1000 / device->Frequency;
+        late = (int)(now - data->lastCallbackTime) - expected;
+        if( late > 0 )
+            data->maxJitter = max( data->maxJitter, late * (int)device->Frequency / 1000 );
+    }
+    data->lastCallbackTime = now;
+
+    if( available < numSamples )
+    {
+        aluDeviceUnderrun( device );
+        SetPreBufferSize( data, size + numSamples );
+        ResetPlaybackWindow( data );
+        data->quietWindows = 0;
+        data->holdWindows = min( data->holdWindows*2, MAX_HOLD_WINDOWS );
+        return;
+    }
+
+    data->lowWater = min( data->lowWater, available - numSamples );
+    data->windowSamples += numSamples;
+    if( data->windowSamples < (int)device->Frequency / 1000 * ADAPT_WINDOW_MS )
+        return;
+
+    needed = numSamples + data->maxJitter;
+    if( ++data->quietWindows >= data->holdWindows && data->lowWater > 0 && size > needed )
+    {
+        SetPreBufferSize( data, max( size - data->lowWater/2, needed ) );
+        data->quietWindows = 0;
+    }
+    ResetPlaybackWindow( data );
+}
+
 int32 s3e_more_audio( void* systemData, void* userData )
 {
     // This code assumes that the function s3e_more_audio 
@@ -121,8 +208,7 @@ int32 s3e_more_audio( void* systemData, void* userData )
     // NOTE: Inside this function we can't call s3eDeviceYield()
     // or any other sleep function (Marmalade limitation)
 
-    int dataLen, dataWritten, len1, len2;
-    uint64 startTime;
+    int dataWritten, buffered;
     ALCdevice *pDevice = (ALCdevice*)userData;
     s3eSoundGenAudioInfo* info = (s3eSoundGenAudioInfo*)systemData;
     s3e_data* data;
@@ -131,7 +217,8 @@ int32 s3e_more_audio( void* systemData, void* userData )
     data = (s3e_data*)pDevice->ExtraData;
 
     // Check if this channel is actually closed or should be closed
-    if( data == NULL || data->killNow || data->thread == NULL || data->thread_exited )
+    if( data == NULL || data->killNow ||
+        (!data->directMix && (data->thread == NULL || data->thread_exited)) )
     {
         data->killNow = 1;
         info->m_EndSample = S3E_TRUE;
@@ -148,39 +235,45 @@ int32 s3e_more_audio( void* systemData, void* userData )
     }
 
     assert( (data->isStereo!=0) == (info->m_Stereo!=0) );
-    assert( data->preBuffer_DataStartIndex >= 0 && data->preBuffer_DataStartIndex < data->preBufferSize );
 
-    // Check how much data is pre-buffered
-    dataLen = getDataInBuffer( data->preBuffer_DataStartIndex, data->preBuffer_DataEndIndex, data->preBufferSize );
-    if( dataLen == 0 )
+    if( data->directMix )
     {
-        // Do NOT return 0. It can work, but it will freeze on iOS
-        // when system alarm is started.
-        //return 0;
+        // Mix straight into s3e's buffer, but only if the context lock is
+        // free now. Every AL call that changes state holds the lock, and
+        // when one does at this moment the whole update is played as
+        // silence and counted as an underrun, rather than waiting for it
+        if( TrySuspendContext( NULL ) )
+        {
+            aluMixData( pDevice, info->m_Target, info->m_NumSamples );
+            ProcessContext( NULL );
+        }
+        else
+        {
+            memset( info->m_Target, 0, info->m_NumSamples * data->bytesPerSample );
+            aluDeviceUnderrun( pDevice );
+        }
+        aluDeviceCallback( pDevice, info->m_NumSamples, 0, info->m_NumSamples );
         return info->m_NumSamples;
     }
 
-    // Copy new data (note: data->preBufferData is a cyclic buffer)
-    dataWritten = min( info->m_NumSamples, dataLen );
-    if( data->preBuffer_DataStartIndex + dataWritten <= data->preBufferSize )
+    UpdatePreBufferSize( pDevice, data, LockFreeRingReadSpace( data->preBuffer ), info->m_NumSamples );
+
+    // Copy the pre-buffered data
+    dataWritten = ReadLockFreeRing( data->preBuffer, (ALubyte*)info->m_Target, info->m_NumSamples );
+    buffered = LockFreeRingReadSpace( data->preBuffer );
+    aluDeviceCallback( pDevice, info->m_NumSamples, buffered, buffered + info->m_NumSamples );
+    if( dataWritten == 0 )
     {
-        // Copy all data in 1 step
-        memcpy( info->m_Target, data->preBufferData + data->preBuffer_DataStartIndex*data->bytesPerSample, dataWritten * data->bytesPerSample );
-    } else {
-        // Copy data in 2 steps
-        len1 = data->preBufferSize - data->preBuffer_DataStartIndex;
-        memcpy( info->m_Target, data->preBufferData + data->preBuffer_DataStartIndex*data->bytesPerSample, len1 * data->bytesPerSample );
-        len2 = dataWritten - len1;
-        if( len2 > 0 ) memcpy( info->m_Target + len1 * data->bytesPerSample/2, data->preBufferData, len2 * data->bytesPerSample );
+        // Do NOT return 0. It can work, but it will freeze on iOS
+        // when system alarm is started.
+        //return 0;
+        return info->m_NumSamples;
     }
 
-    // Increse startIndex
-    len1 = data->preBuffer_DataStartIndex + dataWritten;
-    while( len1 >= data->preBufferSize ) len1 -= data->preBufferSize;
-    data->preBuffer_DataStartIndex = len1;
-
-    // Notify thread that new data is needed
-    s3eThreadSemPost(data->thread_semaphore);
+    // Notify thread that new data is needed, if it's waiting for it. This
+    // also orders the read above before the check
+    if( CompExchangeUInt( &data->mixerWaiting, 1, 0 ) == 1 )
+        s3eThreadSemPost(data->thread_semaphore);
 
     return dataWritten;
 }
@@ -230,12 +323,22 @@ static ALCboolean s3e_open_playback( ALCdevice *device, const ALCchar *deviceNam
     data = (s3e_data*)malloc(sizeof(s3e_data));
     data->channel = freeChannel;
     data->mix_data = NULL;
+    data->directMix = GetConfigValueBool( "s3e", "direct_mix", 0 );
+    // Handing slots to effect threads means waiting on them, which the
+    // callback can't do, so direct mixing processes effects serially
+    if( data->directMix )
+        device->NumEffectThreads = 0;
     data->sampleSize = 0;
     data->bytesPerSample = 0;
-    data->preBufferData = NULL;
+    data->preBuffer = NULL;
+    data->minPreBuffer = 0;
+    data->maxPreBuffer = 0;
     data->preBufferSize = 0;
-    data->preBuffer_DataStartIndex = 0;
-    data->preBuffer_DataEndIndex = 0;
+    data->mixChunk = 0;
+    data->lastCallbackTime = 0;
+    data->quietWindows = 0;
+    data->holdWindows = 1;
+    data->mixerWaiting = 0;
     data->thread = NULL;
     data->killNow = 0;
     data->thread_semaphore = NULL;
@@ -291,12 +394,39 @@ static ALCboolean s3e_reset_playback( ALCdevice *device )
     }
     SetDefaultWFXChannelOrder(device);
 
+    if( data->directMix )
+    {
+        // The callback does all the mixing, so just start playback
+        data->killNow = 0;
+        s3eSoundChannelPlay( data->channel, (int16*)data->mix_data, data->sampleSize * data->bytesPerSample / 2, 0, 0 );
+        return ALC_TRUE;
+    }
+
     // Create semaphore we will use to signal worker thread
     data->thread_semaphore = s3eThreadSemCreate(0);
-    // Create pre-buffer & initialize data
-    data->preBufferSize = data->sampleSize * 3;
-    data->preBufferData = (ALubyte*)calloc( 1, data->preBufferSize * data->bytesPerSample );
-    data->preBuffer_DataStartIndex = data->preBuffer_DataEndIndex = 0;
+    // Create pre-buffer & initialize data. It's allocated for the maximum
+    // latency, and starts at the old fixed size of 3 updates. The callback
+    // then moves it between the latency bounds as it measures playback
+    data->minPreBuffer = GetConfigValueInt( "s3e", "min_latency", 20 ) * (int)device->Frequency / 1000;
+    data->maxPreBuffer = GetConfigValueInt( "s3e", "max_latency", 250 ) * (int)device->Frequency / 1000;
+    data->minPreBuffer = max( data->minPreBuffer, 1 );
+    data->maxPreBuffer = max( data->maxPreBuffer, data->minPreBuffer );
+    data->preBuffer = CreateLockFreeRing( data->bytesPerSample, data->maxPreBuffer );
+    SetPreBufferSize( data, data->sampleSize * 3 );
+    ResetPlaybackWindow( data );
+    data->lastCallbackTime = 0;
+    data->quietWindows = 0;
+    data->holdWindows = 1;
+    data->mixerWaiting = 0;
+    if( !data->preBuffer )
+    {
+        AL_PRINT("pre-buffer malloc failed\n");
+        free(data->mix_data);
+        data->mix_data = NULL;
+        s3eThreadSemDestroy(data->thread_semaphore);
+        data->thread_semaphore = NULL;
+        return ALC_FALSE;
+    }
 
     // Start worker thread
     data->killNow = 0;
@@ -305,9 +435,10 @@ static ALCboolean s3e_reset_playback( ALCdevice *device )
     {
         free(data->mix_data);
         data->mix_data = NULL;
-        free(data->preBufferData);
-        data->preBufferData = NULL;
+        DestroyLockFreeRing(data->preBuffer);
+        data->preBuffer = NULL;
         s3eThreadSemDestroy(data->thread_semaphore);
+        data->thread_semaphore = NULL;
         return ALC_FALSE;
     }
     s3eDeviceYield(20); // Give 20ms to thread to mix first data
@@ -343,19 +474,20 @@ static void s3e_stop_playback( ALCdevice *device )
         // And now really stop the thread
         StopThread( thread );
     }
-    data->preBuffer_DataStartIndex = data->preBuffer_DataEndIndex = 0;
+    data->mixerWaiting = 0;
 
     // Destroy the semaphore
     if(data->thread_semaphore != NULL) s3eThreadSemDestroy(data->thread_semaphore);
+    data->thread_semaphore = NULL;
 
     if( data->mix_data != NULL ) {
         free(data->mix_data);
         data->mix_data = NULL;
     }
 
-    if( data->preBufferData != NULL ) {
-        free(data->preBufferData);
-        data->preBufferData = NULL;
+    if( data->preBuffer != NULL ) {
+        DestroyLockFreeRing(data->preBuffer);
+        data->preBuffer = NULL;
     }
 }
 
@@ -66,6 +66,8 @@ static ALuint SolarisProc(ALvoid *ptr)
         ALubyte *WritePtr = data->mix_data;
 
         aluMixData(pDevice, WritePtr, len/frameSize);
+        aluDeviceCallback(pDevice, len/frameSize, 0,
+                          pDevice->UpdateSize*pDevice->NumUpdates);
         while(len > 0 && !data->killNow)
         {
             wrote = write(data->fd, WritePtr, len);
@@ -28,15 +28,42 @@
 #include "AL/alc.h"
 
 
+/* The mixer fills a ring of blocks, and a separate thread writes them out, so
+ * the mixer doesn't wait on disk I/O. Blocks are in bytes, so the writes stay
+ * large whatever the sample format. Compilers without atomic operations
+ * can't build the ring, so there the mixer writes each update itself. */
+#define WAVE_BLOCK_SIZE (256*1024)
+#define WAVE_NUM_BLOCKS 8
+
 typedef struct {
     FILE *f;
     long DataStart;
 
-    ALvoid *buffer;
-    ALuint size;
+    // Write raw samples, without a WAVE header
+    ALboolean raw;
+    // Force 32-bit float samples
+    ALboolean float32;
+    // Mix in real time, rather than as fast as the file can be written
+    ALboolean realtime;
 
     volatile int killNow;
     ALvoid *thread;
+
+#ifdef HAVE_ATOMIC_OPS
+    LockFreeRing *ring;
+    ALuint blockFrames;
+
+    // The writer thread, and the flags each thread sets when it's about to
+    // wait on the other
+    ALvoid *writer;
+    ALvoid *mixerSem;
+    ALvoid *writerSem;
+    volatile ALuint mixerWaiting;
+    volatile ALuint writerWaiting;
+    volatile ALuint mixerDone;
+#else
+    ALubyte *buffer;
+#endif
 } wave_data;
 
 
@@ -79,23 +106,163 @@ static void fwrite32le(ALuint val, FILE *f)
 }
 
 
+static void WriteHeader(FILE *f, ALuint frequency, ALuint channels, ALuint bits)
+{
+    size_t val;
+
+    fprintf(f, "RIFF");
+    fwrite32le(0xFFFFFFFF, f); // 'RIFF' header len; filled in at close
+
+    fprintf(f, "WAVE");
+
+    fprintf(f, "fmt ");
+    fwrite32le(40, f); // 'fmt ' header len; 40 bytes for EXTENSIBLE
+
+    // 16-bit val, format type id (extensible: 0xFFFE)
+    fwrite16le(0xFFFE, f);
+    // 16-bit val, channel count
+    fwrite16le(channels, f);
+    // 32-bit val, frequency
+    fwrite32le(frequency, f);
+    // 32-bit val, bytes per second
+    fwrite32le(frequency * channels * bits / 8, f);
+    // 16-bit val, frame size
+    fwrite16le(channels * bits / 8, f);
+    // 16-bit val, bits per sample
+    fwrite16le(bits, f);
+    // 16-bit val, extra byte count
+    fwrite16le(22, f);
+    // 16-bit val, valid bits per sample
+    fwrite16le(bits, f);
+    // 32-bit val, channel mask
+    fwrite32le(channel_masks[channels], f);
+    // 16 byte GUID, sub-type format
+    val = fwrite(((bits==32) ? SUBTYPE_FLOAT : SUBTYPE_PCM), 1, 16, f);
+
+    fprintf(f, "data");
+    fwrite32le(0xFFFFFFFF, f); // 'data' header len; filled in at close
+}
+
+/* Swaps the samples in place to little-endian, on big-endian systems */
+static void SwapSamples(ALubyte *bytes, ALuint size, ALuint bytesize)
+{
+    union {
+        short s;
+        char b[sizeof(short)];
+    } uSB;
+    ALubyte tmp;
+    ALuint i;
+
+    uSB.s = 1;
+    if(uSB.b[0] == 1)
+        return;
+
+    if(bytesize == 2)
+    {
+        for(i = 0;i < size;i += 2)
+        {
+            tmp = bytes[i];
+            bytes[i] = bytes[i+1];
+            bytes[i+1] = tmp;
+        }
+    }
+    else if(bytesize == 4)
+    {
+        for(i = 0;i < size;i += 4)
+        {
+            tmp = bytes[i];
+            bytes[i] = bytes[i+3];
+            bytes[i+3] = tmp;
+            tmp = bytes[i+1];
+            bytes[i+1] = bytes[i+2];
+            bytes[i+2] = tmp;
+        }
+    }
+}
+
+#ifdef HAVE_ATOMIC_OPS
+/* Mixes one update into the ring, waiting for the writer to make room if
+ * needed. Returns false if playback was stopped while waiting. */
+static ALboolean MixUpdate(ALCdevice *pDevice, wave_data *data)
+{
+    ALuint todo = pDevice->UpdateSize;
+    ALubyte *WritePtr;
+    ALsizei len;
+
+    while(todo > 0)
+    {
+        if(data->killNow || !pDevice->Connected)
+            return AL_FALSE;
+
+        WritePtr = GetLockFreeRingWritePtr(data->ring, &len);
+        if(len == 0)
+        {
+            // The ring is full. Flag that we're waiting, then check again in
+            // case the writer made room before it could see the flag
+            CompExchangeUInt(&data->mixerWaiting, 0, 1);
+            if(LockFreeRingWriteSpace(data->ring) == 0 && !data->killNow)
+                WaitSem(data->mixerSem);
+            StoreRelease(&data->mixerWaiting, 0);
+            continue;
+        }
+
+        len = min(len, (ALsizei)todo);
+        aluMixData(pDevice, WritePtr, len);
+        LockFreeRingWriteAdvance(data->ring, len);
+        todo -= len;
+
+        if(LockFreeRingReadSpace(data->ring) >= (ALsizei)data->blockFrames &&
+           CompExchangeUInt(&data->writerWaiting, 1, 0) == 1)
+            PostSem(data->writerSem);
+    }
+
+    len = LockFreeRingReadSpace(data->ring);
+    aluDeviceCallback(pDevice, pDevice->UpdateSize, len, len);
+    return AL_TRUE;
+}
+#else
+/* Mixes one update and writes it straight to the file. Returns false if
+ * playback was stopped or the write failed. */
+static ALboolean MixUpdate(ALCdevice *pDevice, wave_data *data)
+{
+    ALuint frameSize = FrameSizeFromDevFmt(pDevice->FmtChans, pDevice->FmtType);
+    size_t fs;
+
+    if(data->killNow || !pDevice->Connected)
+        return AL_FALSE;
+
+    aluMixData(pDevice, data->buffer, pDevice->UpdateSize);
+    SwapSamples(data->buffer, pDevice->UpdateSize*frameSize,
+                BytesFromDevFmt(pDevice->FmtType));
+    fs = fwrite(data->buffer, frameSize, pDevice->UpdateSize, data->f);
+    if(fs != pDevice->UpdateSize || ferror(data->f))
+    {
+        AL_PRINT("Error writing to file\n");
+        aluHandleDisconnect(pDevice);
+        return AL_FALSE;
+    }
+
+    aluDeviceCallback(pDevice, pDevice->UpdateSize, 0, 0);
+    return AL_TRUE;
+}
+#endif
+
 static ALuint WaveProc(ALvoid *ptr)
 {
     ALCdevice *pDevice = (ALCdevice*)ptr;
     wave_data *data = (wave_data*)pDevice->ExtraData;
-    ALuint frameSize;
     ALuint now, start;
     ALuint64 avail, done;
-    size_t fs;
-    union {
-        short s;
-        char b[sizeof(short)];
-    } uSB;
     const ALuint restTime = (ALuint64)pDevice->UpdateSize * 1000 /
                             pDevice->Frequency / 2;
 
-    uSB.s = 1;
-    frameSize = FrameSizeFromDevFmt(pDevice->FmtChans, pDevice->FmtType);
+    if(!data->realtime)
+    {
+        while(MixUpdate(pDevice, data))
+        {
+        }
+        return 0;
+    }
 
     done = 0;
     start = timeGetTime();
@@ -116,48 +283,77 @@ static ALuint WaveProc(ALvoid *ptr)
             Sleep(restTime);
             continue;
         }
+        if(avail-done > pDevice->UpdateSize*pDevice->NumUpdates)
+            aluDeviceUnderrun(pDevice);
 
         while(avail-done >= pDevice->UpdateSize)
         {
-            aluMixData(pDevice, data->buffer, pDevice->UpdateSize);
+            if(!MixUpdate(pDevice, data))
+                break;
             done += pDevice->UpdateSize;
+        }
+    }
 
-            if(uSB.b[0] != 1)
-            {
-                ALuint bytesize = BytesFromDevFmt(pDevice->FmtType);
-                ALubyte *bytes = data->buffer;
-                ALuint i;
-
-                if(bytesize == 1)
-                {
-                    for(i = 0;i < data->size;i++)
-                        fputc(bytes[i], data->f);
-                }
-                else if(bytesize == 2)
-                {
-                    for(i = 0;i < data->size;i++)
-                        fputc(bytes[i^1], data->f);
-                }
-                else if(bytesize == 4)
-                {
-                    for(i = 0;i < data->size;i++)
-                        fputc(bytes[i^3], data->f);
-                }
-            }
-            else
-                fs = fwrite(data->buffer, frameSize, pDevice->UpdateSize,
-                            data->f);
-            if(ferror(data->f))
+    return 0;
+}
+
+#ifdef HAVE_ATOMIC_OPS
+/* Writes the mixed samples to the file a block or more at a time, until the
+ * mixer is stopped and everything it mixed has been written */
+static ALuint WaveWriterProc(ALvoid *ptr)
+{
+    ALCdevice *pDevice = (ALCdevice*)ptr;
+    wave_data *data = (wave_data*)pDevice->ExtraData;
+    ALuint frameSize, bytesize;
+    ALboolean failed = AL_FALSE;
+    ALubyte *ReadPtr;
+    ALsizei len;
+    size_t fs;
+
+    frameSize = FrameSizeFromDevFmt(pDevice->FmtChans, pDevice->FmtType);
+    bytesize = BytesFromDevFmt(pDevice->FmtType);
+
+    while(1)
+    {
+        if(LockFreeRingReadSpace(data->ring) < (ALsizei)data->blockFrames &&
+           !LoadAcquire(&data->mixerDone))
+        {
+            // Not a full block yet. Flag that we're waiting, then check again
+            // in case the mixer filled it before it could see the flag
+            CompExchangeUInt(&data->writerWaiting, 0, 1);
+            if(LockFreeRingReadSpace(data->ring) < (ALsizei)data->blockFrames &&
+               !LoadAcquire(&data->mixerDone))
+                WaitSem(data->writerSem);
+            StoreRelease(&data->writerWaiting, 0);
+            continue;
+        }
+
+        ReadPtr = GetLockFreeRingReadPtr(data->ring, &len);
+        if(len == 0)
+            break;
+
+        // After a write error, the rest is dropped so the mixer can finish
+        if(!failed)
+        {
+            SwapSamples(ReadPtr, len*frameSize, bytesize);
+            fs = fwrite(ReadPtr, frameSize, len, data->f);
+            if(fs != (size_t)len || ferror(data->f))
             {
                 AL_PRINT("Error writing to file\n");
                 aluHandleDisconnect(pDevice);
-                break;
+                failed = AL_TRUE;
             }
         }
+        LockFreeRingReadAdvance(data->ring, len);
+
+        if(CompExchangeUInt(&data->mixerWaiting, 1, 0) == 1)
+            PostSem(data->mixerSem);
     }
 
     return 0;
 }
+#endif
+
 
 static ALCboolean wave_open_playback(ALCdevice *device, const ALCchar *deviceName)
 {
@@ -174,6 +370,9 @@ static ALCboolean wave_open_playback(ALCdevice *device, const ALCchar *deviceNam
         return ALC_FALSE;
 
     data = (wave_data*)calloc(1, sizeof(wave_data));
+    data->raw = GetConfigValueBool("wave", "raw", 0);
+    data->float32 = GetConfigValueBool("wave", "float32", 0);
+    data->realtime = GetConfigValueBool("wave", "realtime", 1);
 
     data->f = fopen(fname, "wb");
     if(!data->f)
@@ -201,11 +400,12 @@ static ALCboolean wave_reset_playback(ALCdevice *device)
 {
     wave_data *data = (wave_data*)device->ExtraData;
     ALuint channels=0, bits=0;
-    size_t val;
 
     fseek(data->f, 0, SEEK_SET);
     clearerr(data->f);
 
+    if(data->float32)
+        device->FmtType = DevFmtFloat;
     switch(device->FmtType)
     {
         case DevFmtByte:
@@ -222,37 +422,8 @@ static ALCboolean wave_reset_playback(ALCdevice *device)
     bits = BytesFromDevFmt(device->FmtType) * 8;
     channels = ChannelsFromDevFmt(device->FmtChans);
 
-    fprintf(data->f, "RIFF");
-    fwrite32le(0xFFFFFFFF, data->f); // 'RIFF' header len; filled in at close
-
-    fprintf(data->f, "WAVE");
-
-    fprintf(data->f, "fmt ");
-    fwrite32le(40, data->f); // 'fmt ' header len; 40 bytes for EXTENSIBLE
-
-    // 16-bit val, format type id (extensible: 0xFFFE)
-    fwrite16le(0xFFFE, data->f);
-    // 16-bit val, channel count
-    fwrite16le(channels, data->f);
-    // 32-bit val, frequency
-    fwrite32le(device->Frequency, data->f);
-    // 32-bit val, bytes per second
-    fwrite32le(device->Frequency * channels * bits / 8, data->f);
-    // 16-bit val, frame size
-    fwrite16le(channels * bits / 8, data->f);
-    // 16-bit val, bits per sample
-    fwrite16le(bits, data->f);
-    // 16-bit val, extra byte count
-    fwrite16le(22, data->f);
-    // 16-bit val, valid bits per sample
-    fwrite16le(bits, data->f);
-    // 32-bit val, channel mask
-    fwrite32le(channel_masks[channels], data->f);
-    // 16 byte GUID, sub-type format
-    val = fwrite(((bits==32) ? SUBTYPE_FLOAT : SUBTYPE_PCM), 1, 16, data->f);
-
-    fprintf(data->f, "data");
-    fwrite32le(0xFFFFFFFF, data->f); // 'data' header len; filled in at close
+    if(!data->raw)
+        WriteHeader(data->f, device->Frequency, channels, bits);
 
     if(ferror(data->f))
     {
@@ -262,8 +433,51 @@ static ALCboolean wave_reset_playback(ALCdevice *device)
 
     data->DataStart = ftell(data->f);
 
-    data->size = device->UpdateSize * channels * bits / 8;
-    data->buffer = malloc(data->size);
+#ifdef HAVE_ATOMIC_OPS
+    data->blockFrames = WAVE_BLOCK_SIZE / (channels * bits / 8);
+    data->ring = CreateLockFreeRing(channels * bits / 8,
+                                    data->blockFrames * WAVE_NUM_BLOCKS);
+    data->mixerSem = CreateSem(0);
+    data->writerSem = CreateSem(0);
+    if(!data->ring || !data->mixerSem || !data->writerSem)
+    {
+        AL_PRINT("Failed to create the write ring\n");
+        goto error;
+    }
+    data->mixerWaiting = 0;
+    data->writerWaiting = 0;
+    data->mixerDone = 0;
+
+    SetDefaultWFXChannelOrder(device);
+
+    data->writer = StartThread(WaveWriterProc, device);
+    if(data->writer == NULL)
+        goto error;
+
+    data->thread = StartThread(WaveProc, device);
+    if(data->thread == NULL)
+    {
+        StoreRelease(&data->mixerDone, 1);
+        PostSem(data->writerSem);
+        StopThread(data->writer);
+        data->writer = NULL;
+        goto error;
+    }
+
+    return ALC_TRUE;
+
+error:
+    if(data->mixerSem)
+        DestroySem(data->mixerSem);
+    if(data->writerSem)
+        DestroySem(data->writerSem);
+    data->mixerSem = NULL;
+    data->writerSem = NULL;
+    DestroyLockFreeRing(data->ring);
+    data->ring = NULL;
+    return ALC_FALSE;
+#else
+    data->buffer = malloc(device->UpdateSize * channels * bits / 8);
     if(!data->buffer)
     {
         AL_PRINT("buffer malloc failed\n");
@@ -281,6 +495,7 @@ static ALCboolean wave_reset_playback(ALCdevice *device)
     }
 
     return ALC_TRUE;
+#endif
 }
 
 static void wave_stop_playback(ALCdevice *device)
@@ -293,16 +508,35 @@ static void wave_stop_playback(ALCdevice *device)
         return;
 
     data->killNow = 1;
+#ifdef HAVE_ATOMIC_OPS
+    // Wake the mixer in case it's waiting for room in the ring
+    PostSem(data->mixerSem);
+#endif
     StopThread(data->thread);
     data->thread = NULL;
 
     data->killNow = 0;
 
+#ifdef HAVE_ATOMIC_OPS
+    // Let the writer finish what was mixed
+    StoreRelease(&data->mixerDone, 1);
+    PostSem(data->writerSem);
+    StopThread(data->writer);
+    data->writer = NULL;
+
+    DestroySem(data->mixerSem);
+    DestroySem(data->writerSem);
+    data->mixerSem = NULL;
+    data->writerSem = NULL;
+    DestroyLockFreeRing(data->ring);
+    data->ring = NULL;
+#else
     free(data->buffer);
     data->buffer = NULL;
+#endif
 
     size = ftell(data->f);
-    if(size > 0)
+    if(size > 0 && !data->raw)
     {
         dataLen = size - data->DataStart;
         if(fseek(data->f, data->DataStart-4, SEEK_SET) == 0)
@@ -203,7 +203,14 @@ static DWORD WINAPI PlaybackThreadProc(LPVOID lpParameter)
 
         pWaveHdr = ((LPWAVEHDR)msg.lParam);
 
+        // Every buffer was returned before this one could be refilled
+        if(pData->lWaveBuffersCommitted == 0)
+            aluDeviceUnderrun(pDevice);
+
         aluMixData(pDevice, pWaveHdr->lpData, pWaveHdr->dwBufferLength/FrameSize);
+        aluDeviceCallback(pDevice, pWaveHdr->dwBufferLength/FrameSize, 0,
+                          (pData->lWaveBuffersCommitted+1) *
+                          pWaveHdr->dwBufferLength/FrameSize);
 
         // Send buffer back to play more data
         waveOutWrite(pData->hWaveHandle.Out, pWaveHdr, sizeof(WAVEHDR));
@@ -25,6 +25,20 @@ typedef struct ALeffectslot
     ALfloat ClickRemoval[1];
     ALfloat PendingClicks[1];
 
+    // Estimated output level of the effect's tail. Processing is skipped
+    // while it and the input are below the sleep level.
+    ALfloat TailLevel;
+    ALuint  TailHoldCount;
+    // Tail properties of the current effect: the output gain relative to
+    // the input, the time (in seconds) the tail holds before decaying, and
+    // the time it takes to decay by 60dB (negative if it never ends).
+    ALfloat TailGain;
+    ALfloat TailHold;
+    ALfloat TailDecay;
+
+    // Whether the slot is in its context's active slot list
+    ALboolean Active;
+
     ALuint refcount;
 
     // Index to itself
@@ -49,6 +63,15 @@ ALeffectState *EAXVerbCreate(void);
 ALeffectState *VerbCreate(void);
 ALeffectState *EchoCreate(void);
 ALeffectState *ModulatorCreate(void);
+ALeffectState *EqualizerCreate(void);
+ALeffectState *CompressorCreate(void);
+ALeffectState *ChorusCreate(void);
+ALeffectState *FlangerCreate(void);
+
+ALvoid ModulatorInitTables(void);
+
+ALfloat *AllocEffectSamples(ALCdevice *device, ALuint count);
+ALvoid FreeEffectSamples(ALCdevice *device, ALfloat *samples, ALuint count);
 
 #define ALEffect_Destroy(a)         ((a)->Destroy((a)))
 #define ALEffect_DeviceUpdate(a,b)  ((a)->DeviceUpdate((a),(b)))
@@ -66,6 +66,26 @@ static __inline ALuint FrameSizeFromFmt(enum FmtChannels chans, enum FmtType typ
 }
 
 
+/* Sample storage shared between buffers holding identical data */
+typedef struct ALbufferStore
+{
+    ALvoid  *data;
+    ALsizei  size;
+
+    ALsizei          Frequency;
+    enum FmtChannels FmtChannels;
+    enum FmtType     FmtType;
+
+    ALuint hash;
+    ALuint refcount; // Number of buffers using this storage
+
+    struct ALbufferStore *next;
+    struct ALbufferStore **prev;
+} ALbufferStore;
+
+ALsizei BufferStoreBytesSaved(ALCdevice *device);
+
+
 typedef struct ALbuffer
 {
     ALvoid  *data;
@@ -83,6 +103,18 @@ typedef struct ALbuffer
     ALsizei  LoopStart;
     ALsizei  LoopEnd;
 
+    // Data is owned by the app (alBufferDataStatic); never realloc'd or freed
+    ALboolean StaticData;
+    // Databuffer the static data lives in, if any
+    struct ALdatabuffer *Databuffer;
+
+    // Shared storage data belongs to, if any; must be unshared before writing
+    ALbufferStore *Store;
+
+    // Set while an async upload is converting data for this buffer
+    volatile ALboolean Pending;
+    ALenum AsyncError;
+
     ALuint   refcount; // Number of sources using this buffer (deletion can only occur when this is 0)
 
     // Index to itself
@@ -90,6 +122,7 @@ typedef struct ALbuffer
 } ALbuffer;
 
 ALvoid ReleaseALBuffers(ALCdevice *device);
+ALvoid StopBufferThread(ALCdevice *device);
 
 #ifdef __cplusplus
 }
@@ -18,6 +18,13 @@ typedef struct ALdatabuffer
     ALenum state;
     ALenum usage;
 
+    /* Set when data is a view of a memory-mapped file */
+    ALvoid *MapBase;
+    size_t  MapSize;
+
+    /* Number of static ALbuffers referencing data */
+    ALuint refcount;
+
     /* Index to self */
     ALuint databuffer;
 
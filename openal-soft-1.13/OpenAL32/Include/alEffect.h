@@ -14,6 +14,10 @@ enum {
     REVERB,
     ECHO,
     MODULATOR,
+    EQUALIZER,
+    COMPRESSOR,
+    CHORUS,
+    FLANGER,
 
     MAX_EFFECTS
 };
@@ -69,6 +73,33 @@ typedef struct ALeffect
         ALint Waveform;
     } Modulator;
 
+    struct {
+        ALfloat LowGain;
+        ALfloat LowCutoff;
+        ALfloat Mid1Gain;
+        ALfloat Mid1Center;
+        ALfloat Mid1Width;
+        ALfloat Mid2Gain;
+        ALfloat Mid2Center;
+        ALfloat Mid2Width;
+        ALfloat HighGain;
+        ALfloat HighCutoff;
+    } Equalizer;
+
+    struct {
+        ALint OnOff;
+    } Compressor;
+
+    // Shared by the chorus and flanger
+    struct {
+        ALint Waveform;
+        ALint Phase;
+        ALfloat Rate;
+        ALfloat Depth;
+        ALfloat Feedback;
+        ALfloat Delay;
+    } Chorus;
+
     // Index to itself
     ALuint effect;
 } ALeffect;
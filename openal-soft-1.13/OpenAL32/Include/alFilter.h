@@ -98,6 +98,19 @@ static __inline ALfloat lpFilter1PC(FILTER *iir, ALuint offset, ALfloat input)
     return output;
 }
 
+/* The high-pass filter is a low-shelf, subtracting a scaled low-passed copy of
+ * the input from itself. Frequencies below the cutoff are scaled by 1-scale,
+ * while higher frequencies pass through. */
+static __inline ALfloat hpFilter1P(FILTER *iir, ALfloat scale, ALuint offset, ALfloat input)
+{
+    return input - lpFilter1P(iir, offset, input)*scale;
+}
+
+static __inline ALfloat hpFilter1PC(FILTER *iir, ALfloat scale, ALuint offset, ALfloat input)
+{
+    return input - lpFilter1PC(iir, offset, input)*scale;
+}
+
 /* Calculates the low-pass filter coefficient given the pre-scaled gain and
  * cos(w) value. Note that g should be pre-scaled (sqr(gain) for one-pole,
  * sqrt(gain) for four-pole, etc) */
@@ -123,6 +136,7 @@ typedef struct ALfilter
 
     ALfloat Gain;
     ALfloat GainHF;
+    ALfloat GainLF;
 
     // Index to itself
     ALuint filter;
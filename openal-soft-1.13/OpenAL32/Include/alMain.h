@@ -69,6 +69,85 @@ AL_API ALvoid AL_APIENTRY alUnmapDatabufferEXT(ALuint uiBuffer);
 #endif
 #endif
 
+#ifndef AL_SOFTX_databuffer_file
+#define AL_SOFTX_databuffer_file 1
+typedef ALvoid (AL_APIENTRY*PFNALDATABUFFERFILESOFTPROC)(ALuint buffer, const ALchar *filename, ALintptrEXT start, ALsizeiptrEXT length);
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API ALvoid AL_APIENTRY alDatabufferFileSOFT(ALuint buffer, const ALchar *filename, ALintptrEXT start, ALsizeiptrEXT length);
+#endif
+#endif
+
+#ifndef ALC_SOFTX_buffer_dedup
+#define ALC_SOFTX_buffer_dedup 1
+#define ALC_BUFFER_BYTES_SAVED_SOFT              0x1A00
+#endif
+
+#ifndef ALC_SOFTX_effect_slot_stats
+#define ALC_SOFTX_effect_slot_stats 1
+#define ALC_EFFECT_SLOT_UPDATES_SKIPPED_SOFT     0x1A01
+#endif
+
+#ifndef ALC_SOFTX_effect_memory
+#define ALC_SOFTX_effect_memory 1
+#define ALC_EFFECT_MEMORY_SOFT                   0x1A02
+#endif
+
+#ifndef ALC_SOFTX_device_stats
+#define ALC_SOFTX_device_stats 1
+#define ALC_DEVICE_STATS_SIZE_SOFT               0x1A03
+#define ALC_DEVICE_STATS_SOFT                    0x1A04
+#define ALC_UNDERRUNS_SOFT                       0x1A05
+#define ALC_MIX_TIME_MIN_SOFT                    0x1A06
+#define ALC_MIX_TIME_AVG_SOFT                    0x1A07
+#define ALC_MIX_TIME_MAX_SOFT                    0x1A08
+#define ALC_BUFFERED_SAMPLES_SOFT                0x1A09
+#define ALC_CALLBACK_JITTER_SOFT                 0x1A0A
+#define ALC_OUTPUT_LATENCY_SOFT                  0x1A0B
+#endif
+
+#ifndef ALC_SOFT_loopback
+#define ALC_SOFT_loopback 1
+#define ALC_FORMAT_CHANNELS_SOFT                 0x1990
+#define ALC_FORMAT_TYPE_SOFT                     0x1991
+
+/* Sample types */
+#define ALC_BYTE_SOFT                            0x1400
+#define ALC_UNSIGNED_BYTE_SOFT                   0x1401
+#define ALC_SHORT_SOFT                           0x1402
+#define ALC_UNSIGNED_SHORT_SOFT                  0x1403
+#define ALC_INT_SOFT                             0x1404
+#define ALC_UNSIGNED_INT_SOFT                    0x1405
+#define ALC_FLOAT_SOFT                           0x1406
+
+/* Channel configurations */
+#define ALC_MONO_SOFT                            0x1500
+#define ALC_STEREO_SOFT                          0x1501
+#define ALC_QUAD_SOFT                            0x1503
+#define ALC_5POINT1_SOFT                         0x1504
+#define ALC_6POINT1_SOFT                         0x1505
+#define ALC_7POINT1_SOFT                         0x1506
+
+typedef ALCdevice* (ALC_APIENTRY*LPALCLOOPBACKOPENDEVICESOFT)(const ALCchar *deviceName);
+typedef ALCboolean (ALC_APIENTRY*LPALCISRENDERFORMATSUPPORTEDSOFT)(ALCdevice *device, ALCsizei freq, ALCenum channels, ALCenum type);
+typedef void (ALC_APIENTRY*LPALCRENDERSAMPLESSOFT)(ALCdevice *device, ALCvoid *buffer, ALCsizei samples);
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API ALCdevice* ALC_APIENTRY alcLoopbackOpenDeviceSOFT(const ALCchar *deviceName);
+ALC_API ALCboolean ALC_APIENTRY alcIsRenderFormatSupportedSOFT(ALCdevice *device, ALCsizei freq, ALCenum channels, ALCenum type);
+ALC_API void ALC_APIENTRY alcRenderSamplesSOFT(ALCdevice *device, ALCvoid *buffer, ALCsizei samples);
+#endif
+#endif
+
+#ifndef AL_SOFTX_async_buffer_data
+#define AL_SOFTX_async_buffer_data 1
+#define AL_BUFFER_PENDING_SOFT                   0x2016
+typedef ALvoid (AL_APIENTRY*PFNALBUFFERDATAASYNCSOFTPROC)(ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei freq);
+typedef ALvoid (AL_APIENTRY*PFNALWAITBUFFERSOFTPROC)(ALuint buffer);
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API ALvoid AL_APIENTRY alBufferDataAsyncSOFT(ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei freq);
+AL_API ALvoid AL_APIENTRY alWaitBufferSOFT(ALuint buffer);
+#endif
+#endif
+
 
 #if defined(HAVE_STDINT_H)
 #include <stdint.h>
@@ -104,6 +183,18 @@ typedef DWORD tls_type;
 #define tls_get(x) TlsGetValue((x))
 #define tls_set(x, a) TlsSetValue((x), (a))
 
+/* Microseconds from an arbitrary starting point, for timing the mixer */
+static __inline ALuint64 GetMicroTime(void)
+{
+    LARGE_INTEGER count, freq;
+
+    if(!QueryPerformanceFrequency(&freq) || !QueryPerformanceCounter(&count))
+        return (ALuint64)timeGetTime() * 1000;
+    return (ALuint64)(count.QuadPart / freq.QuadPart * 1000000) +
+           (ALuint64)(count.QuadPart % freq.QuadPart * 1000000 /
+                      freq.QuadPart);
+}
+
 #else
 
 #include <unistd.h>
@@ -158,6 +249,23 @@ static __inline void EnterCriticalSection(CRITICAL_SECTION *cs)
         (*cs)->recursion = 1;
     }
 }
+static __inline int TryEnterCriticalSection(CRITICAL_SECTION *cs)
+{
+    s3eThread *currThread = s3eThreadGetCurrent();
+    assert( (*cs) != NULL );
+
+    if( currThread == (*cs)->lockingThread )
+    {
+        (*cs)->recursion ++;
+        return 1;
+    }
+    if( s3eThreadLockAcquire( (*cs)->mutex, 0 ) != S3E_RESULT_SUCCESS )
+        return 0;
+    assert( (*cs)->recursion == 0 );
+    (*cs)->lockingThread = currThread;
+    (*cs)->recursion = 1;
+    return 1;
+}
 static __inline void LeaveCriticalSection(CRITICAL_SECTION *cs)
 {
     int ret;
@@ -197,6 +305,10 @@ static __inline void EnterCriticalSection(CRITICAL_SECTION *cs)
     ret = pthread_mutex_lock(cs);
     assert(ret == 0);
 }
+static __inline int TryEnterCriticalSection(CRITICAL_SECTION *cs)
+{
+    return pthread_mutex_trylock(cs) == 0;
+}
 static __inline void LeaveCriticalSection(CRITICAL_SECTION *cs)
 {
     int ret;
@@ -266,6 +378,37 @@ static __inline ALuint timeGetTime(void)
 #endif
 }
 
+/* Microseconds from an arbitrary starting point, for timing the mixer */
+static __inline ALuint64 GetMicroTime(void)
+{
+#if _POSIX_TIMERS > 0
+    struct timespec ts;
+    int ret = -1;
+
+#if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK >= 0)
+#if _POSIX_MONOTONIC_CLOCK == 0
+    static int hasmono = 0;
+    if(hasmono > 0 || (hasmono == 0 &&
+                       (hasmono=sysconf(_SC_MONOTONIC_CLOCK)) > 0))
+#endif
+        ret = clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    if(ret != 0)
+        ret = clock_gettime(CLOCK_REALTIME, &ts);
+    assert(ret == 0);
+
+    return (ALuint64)ts.tv_sec*1000000 + ts.tv_nsec/1000;
+#else
+    struct timeval tv;
+    int ret;
+
+    ret = gettimeofday(&tv, NULL);
+    assert(ret == 0);
+
+    return (ALuint64)tv.tv_sec*1000000 + tv.tv_usec;
+#endif
+}
+
 static __inline void Sleep(ALuint t)
 {
     struct timespec tv, rem;
@@ -279,6 +422,62 @@ static __inline void Sleep(ALuint t)
 #define max(x,y) (((x)>(y))?(x):(y))
 #endif
 
+
+/* Ordered access to values shared between threads without a lock. A load-
+ * acquire sees everything written before the matching store-release, and
+ * CompExchangeUInt is a full barrier. volatile alone doesn't keep the CPU
+ * from reordering accesses (e.g. on ARM). HAVE_ATOMIC_OPS is left undefined
+ * for compilers without them, and code that needs them isn't built. */
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#define HAVE_ATOMIC_OPS 1
+static __inline ALuint LoadAcquire(volatile ALuint *ptr)
+{ return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+static __inline void StoreRelease(volatile ALuint *ptr, ALuint val)
+{ __atomic_store_n(ptr, val, __ATOMIC_RELEASE); }
+static __inline ALuint CompExchangeUInt(volatile ALuint *ptr, ALuint oldval, ALuint newval)
+{ return __sync_val_compare_and_swap(ptr, oldval, newval); }
+#elif defined(__GNUC__)
+#define HAVE_ATOMIC_OPS 1
+static __inline ALuint LoadAcquire(volatile ALuint *ptr)
+{ ALuint val = *ptr; __sync_synchronize(); return val; }
+static __inline void StoreRelease(volatile ALuint *ptr, ALuint val)
+{ __sync_synchronize(); *ptr = val; }
+static __inline ALuint CompExchangeUInt(volatile ALuint *ptr, ALuint oldval, ALuint newval)
+{ return __sync_val_compare_and_swap(ptr, oldval, newval); }
+#elif defined(_WIN32)
+#define HAVE_ATOMIC_OPS 1
+static __inline ALuint LoadAcquire(volatile ALuint *ptr)
+{ ALuint val = *ptr; MemoryBarrier(); return val; }
+static __inline void StoreRelease(volatile ALuint *ptr, ALuint val)
+{ MemoryBarrier(); *ptr = val; }
+static __inline ALuint CompExchangeUInt(volatile ALuint *ptr, ALuint oldval, ALuint newval)
+{ return InterlockedCompareExchange((volatile LONG*)ptr, newval, oldval); }
+#elif defined(__ARMCC_VERSION) && defined(__TARGET_ARCH_7)
+/* ARM's own compiler (RVCT), which some Marmalade ARM builds use. The DMB and
+ * exclusive load/store intrinsics need ARMv7 */
+#define HAVE_ATOMIC_OPS 1
+static __inline ALuint LoadAcquire(volatile ALuint *ptr)
+{ ALuint val = *ptr; __dmb(0xF); return val; }
+static __inline void StoreRelease(volatile ALuint *ptr, ALuint val)
+{ __dmb(0xF); *ptr = val; }
+static __inline ALuint CompExchangeUInt(volatile ALuint *ptr, ALuint oldval, ALuint newval)
+{
+    ALuint val;
+
+    __dmb(0xF);
+    do {
+        val = __ldrex(ptr);
+        if(val != oldval)
+        {
+            __clrex();
+            break;
+        }
+    } while(__strex(newval, ptr) != 0);
+    __dmb(0xF);
+    return val;
+}
+#endif
+
 #include "alListener.h"
 #include "alu.h"
 
@@ -293,6 +492,7 @@ extern "C" {
 #define AIRABSORBGAINDBHF          (-0.05f)
 
 #define LOWPASSFREQCUTOFF          (5000)
+#define HIGHPASSFREQCUTOFF         (250)
 
 #define DEFAULT_HEAD_DAMPEN        (0.25f)
 
@@ -362,6 +562,9 @@ void alc_pulse_probe(int type);
 void alc_null_init(BackendFuncs *func_list);
 void alc_null_deinit(void);
 void alc_null_probe(int type);
+void alc_loopback_init(BackendFuncs *func_list);
+void alc_loopback_deinit(void);
+void alc_loopback_probe(int type);
 void alc_s3e_init(BackendFuncs *func_list);
 void alc_s3e_deinit(void);
 void alc_s3e_probe(int type);
@@ -401,6 +604,13 @@ enum DevFmtChannels {
     DevFmtX71,    /* AL_7POINT1 */
 };
 
+/* Storage for float buffer data */
+enum BufferStorage {
+    BufferStorageFloat, /* Keep as float */
+    BufferStorageShort, /* Convert to 16-bit */
+    BufferStorageAuto,  /* Convert to 16-bit unless it would clip */
+};
+
 ALuint BytesFromDevFmt(enum DevFmtType type);
 ALuint ChannelsFromDevFmt(enum DevFmtChannels chans);
 static __inline ALuint FrameSizeFromDevFmt(enum DevFmtChannels chans,
@@ -410,10 +620,46 @@ static __inline ALuint FrameSizeFromDevFmt(enum DevFmtChannels chans,
 }
 
 
+/* Playback statistics. Times are in microseconds and buffer levels in sample
+ * frames. The mix time and jitter are measured over the last second, while
+ * the rest are cumulative or current. The mix times are published together
+ * under the context lock. The backend's values are each written on their
+ * own without it, since some backends report them from callbacks that can't
+ * wait on the lock. */
+typedef struct ALCdeviceStats {
+    ALuint Underruns;
+    ALuint MixTimeMin;
+    ALuint MixTimeAvg;
+    ALuint MixTimeMax;
+    ALuint BufferedSamples;
+    ALuint Jitter;
+    ALuint Latency;
+
+    // Running values toward the next second's mix times, only used by the
+    // mixer. A finished second's times wait in MixDone* until the mixer next
+    // holds the lock
+    ALuint MixMin;
+    ALuint MixMax;
+    ALuint64 MixTotal;
+    ALuint MixCount;
+    ALuint MixSamples;
+    ALboolean MixDone;
+    ALuint MixDoneMin;
+    ALuint MixDoneAvg;
+    ALuint MixDoneMax;
+
+    // Running values toward the next second's jitter, updated by the backend
+    ALuint64 LastCallback;
+    ALuint LastCallbackSamples;
+    ALuint CallbackJitter;
+    ALuint CallbackSamples;
+} ALCdeviceStats;
+
 struct ALCdevice_struct
 {
     ALCboolean   Connected;
     ALboolean    IsCaptureDevice;
+    ALboolean    IsLoopbackDevice;
 
     ALuint       Frequency;
     ALuint       UpdateSize;
@@ -450,6 +696,10 @@ struct ALCdevice_struct
     struct bs2b *Bs2b;
     ALCint       Bs2bLevel;
 
+    // Limiter keeping the mix's peaks within full-scale
+    struct MasterLimiter *Limiter;
+    ALboolean    UseLimiter;
+
     // Simulated dampening from head occlusion
     ALfloat      HeadDampen;
 
@@ -477,6 +727,41 @@ struct ALCdevice_struct
     BackendFuncs *Funcs;
     void         *ExtraData; // For the backend's use
 
+    // How float buffer data is stored, and whether to dither it to 16-bit
+    enum BufferStorage BufferStorage;
+    ALboolean          DitherBuffers;
+
+    // Sample storage shared between identical buffers, if enabled
+    ALboolean            ShareBuffers;
+    struct ALbufferStore *BufferStores;
+
+    // Pending alBufferDataAsyncSOFT uploads, and the thread converting them.
+    // BufferJobSem is posted for each queued job, and BufferDoneSem once for
+    // each alWaitBufferSOFT caller when a job finishes
+    struct ALbufferJob *BufferJobs;
+    ALvoid             *BufferThread;
+    volatile ALboolean  KillBufferThread;
+    ALvoid             *BufferJobSem;
+    ALvoid             *BufferDoneSem;
+    ALuint              BufferWaiters;
+
+    // Effect slot updates skipped by the mixer over the last second, and the
+    // running count toward the next
+    ALuint SlotsSkippedRate;
+    ALuint SlotsSkipped;
+    ALuint SlotStatSamples;
+
+    // Playback statistics for ALC_SOFTX_device_stats
+    ALCdeviceStats Stats;
+
+    // Arena holding the effects' delay lines, and its size in bytes
+    struct EffectMemChunk *EffectMem;
+    ALuint EffectMemBytes;
+
+    // Worker threads processing effect slots in parallel, if enabled
+    ALuint NumEffectThreads;
+    struct EffectThreadPool *EffectPool;
+
     ALCdevice *next;
 };
 
@@ -516,6 +801,11 @@ struct ALCcontext_struct
     ALsizei           ActiveSourceCount;
     ALsizei           MaxActiveSources;
 
+    // Effect slots that are being sent to or still have a tail to play
+    struct ALeffectslot **ActiveEffectSlots;
+    ALsizei               ActiveEffectSlotCount;
+    ALsizei               MaxActiveEffectSlots;
+
     ALCdevice  *Device;
     const ALCchar *ExtensionList;
 
@@ -529,11 +819,17 @@ void AppendCaptureDeviceList(const ALCchar *name);
 ALCvoid alcSetError(ALCdevice *device, ALenum errorCode);
 
 ALCvoid SuspendContext(ALCcontext *context);
+ALCboolean TrySuspendContext(ALCcontext *context);
 ALCvoid ProcessContext(ALCcontext *context);
 
 ALvoid *StartThread(ALuint (*func)(ALvoid*), ALvoid *ptr);
 ALuint StopThread(ALvoid *thread);
 
+ALvoid *CreateSem(ALuint count);
+ALvoid PostSem(ALvoid *sem);
+ALvoid WaitSem(ALvoid *sem);
+ALvoid DestroySem(ALvoid *sem);
+
 ALCcontext *GetContextSuspended(void);
 
 typedef struct RingBuffer RingBuffer;
@@ -543,6 +839,20 @@ ALsizei RingBufferSize(RingBuffer *ring);
 void WriteRingBuffer(RingBuffer *ring, const ALubyte *data, ALsizei len);
 void ReadRingBuffer(RingBuffer *ring, ALubyte *data, ALsizei len);
 
+#ifdef HAVE_ATOMIC_OPS
+typedef struct LockFreeRing LockFreeRing;
+LockFreeRing *CreateLockFreeRing(ALsizei frame_size, ALsizei length);
+void DestroyLockFreeRing(LockFreeRing *ring);
+void ResetLockFreeRing(LockFreeRing *ring);
+ALsizei LockFreeRingReadSpace(LockFreeRing *ring);
+ALsizei LockFreeRingWriteSpace(LockFreeRing *ring);
+ALubyte *GetLockFreeRingWritePtr(LockFreeRing *ring, ALsizei *len);
+void LockFreeRingWriteAdvance(LockFreeRing *ring, ALsizei len);
+ALubyte *GetLockFreeRingReadPtr(LockFreeRing *ring, ALsizei *len);
+void LockFreeRingReadAdvance(LockFreeRing *ring, ALsizei len);
+ALsizei ReadLockFreeRing(LockFreeRing *ring, ALubyte *data, ALsizei len);
+#endif
+
 void ReadALConfig(void);
 void FreeALConfig(void);
 int ConfigValueExists(const char *blockName, const char *keyName);
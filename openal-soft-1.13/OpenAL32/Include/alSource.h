@@ -22,6 +22,14 @@ typedef enum {
 } resampler_t;
 extern resampler_t DefaultResampler;
 
+/* The filter kernels the mixer runs on a source. Each adds a stage over the
+ * last, so sources only pay for the filtering they use */
+typedef enum {
+    LOWPASS_FILTER = 0,
+    HIGHPASS_FILTER,
+    BANDPASS_FILTER
+} filter_t;
+
 extern const ALsizei ResamplerPadding[RESAMPLER_MAX];
 extern const ALsizei ResamplerPrePadding[RESAMPLER_MAX];
 
@@ -98,11 +106,23 @@ typedef struct ALsource
         FILTER iirFilter;
         ALfloat history[MAXCHANNELS*2];
 
+        /* The low-shelf for high-pass and band-pass filters, and how much it
+         * cuts. One pole per channel */
+        ALfloat lfScale;
+        FILTER lfFilter;
+        ALfloat lfHistory[MAXCHANNELS];
+
         struct {
             ALfloat WetGain;
             FILTER iirFilter;
             ALfloat history[MAXCHANNELS];
+
+            ALfloat lfScale;
+            FILTER lfFilter;
+            ALfloat lfHistory[MAXCHANNELS];
         } Send[MAX_SENDS];
+
+        filter_t FilterType;
     } Params;
 
     ALvoid (*Update)(struct ALsource *self, const ALCcontext *context);
@@ -122,6 +122,16 @@ ALvoid MixSource(struct ALsource *Source, ALCdevice *Device, ALuint SamplesToDo)
 
 ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size);
 ALvoid aluHandleDisconnect(ALCdevice *device);
+ALvoid aluDeviceCallback(ALCdevice *device, ALuint samples, ALuint buffered, ALuint latency);
+ALvoid aluDeviceUnderrun(ALCdevice *device);
+ALvoid aluResetDeviceStats(ALCdevice *device);
+
+ALboolean StartEffectThreads(ALCdevice *device);
+ALvoid StopEffectThreads(ALCdevice *device);
+
+struct MasterLimiter *CreateMasterLimiter(void);
+ALvoid ResetMasterLimiter(struct MasterLimiter *limiter, ALuint frequency);
+ALvoid ApplyMasterLimiter(struct MasterLimiter *limiter, ALfloat (*Buffer)[MAXCHANNELS], ALuint SamplesToDo);
 
 #ifdef __cplusplus
 }
@@ -33,6 +33,8 @@
 
 
 static ALvoid InitializeEffect(ALCcontext *Context, ALeffectslot *EffectSlot, ALeffect *effect);
+static ALvoid UpdateSlotTail(ALeffectslot *EffectSlot);
+static ALboolean ReserveActiveEffectSlots(ALCcontext *Context, ALsizei count);
 
 #define LookupEffectSlot(m, k) ((ALeffectslot*)LookupUIntMapKey(&(m), (k)))
 #define LookupEffect(m, k) ((ALeffect*)LookupUIntMapKey(&(m), (k)))
@@ -50,6 +52,8 @@ AL_API ALvoid AL_APIENTRY alGenAuxiliaryEffectSlots(ALsizei n, ALuint *effectslo
         alSetError(Context, AL_INVALID_VALUE);
     else if((ALuint)n > Device->AuxiliaryEffectSlotMax - Context->EffectSlotMap.size)
         alSetError(Context, AL_INVALID_VALUE);
+    else if(!ReserveActiveEffectSlots(Context, Context->EffectSlotMap.size + n))
+        alSetError(Context, AL_OUT_OF_MEMORY);
     else
     {
         ALenum err;
@@ -93,6 +97,10 @@ AL_API ALvoid AL_APIENTRY alGenAuxiliaryEffectSlots(ALsizei n, ALuint *effectslo
                 slot->ClickRemoval[j] = 0.0f;
                 slot->PendingClicks[j] = 0.0f;
             }
+            slot->TailLevel = 0.0f;
+            slot->TailHoldCount = 0;
+            UpdateSlotTail(slot);
+            slot->Active = AL_FALSE;
             slot->refcount = 0;
         }
     }
@@ -142,6 +150,21 @@ AL_API ALvoid AL_APIENTRY alDeleteAuxiliaryEffectSlots(ALsizei n, ALuint *effect
             if((EffectSlot=LookupEffectSlot(Context->EffectSlotMap, effectslots[i])) == NULL)
                 continue;
 
+            if(EffectSlot->Active)
+            {
+                // Take it out of the mixer's list
+                ALsizei j;
+                for(j = 0;j < Context->ActiveEffectSlotCount;j++)
+                {
+                    if(Context->ActiveEffectSlots[j] == EffectSlot)
+                    {
+                        ALsizei end = --(Context->ActiveEffectSlotCount);
+                        Context->ActiveEffectSlots[j] = Context->ActiveEffectSlots[end];
+                        break;
+                    }
+                }
+            }
+
             ALEffect_Destroy(EffectSlot->EffectState);
 
             RemoveUIntMapKey(&Context->EffectSlotMap, EffectSlot->effectslot);
@@ -488,6 +511,14 @@ static ALvoid InitializeEffect(ALCcontext *Context, ALeffectslot *EffectSlot, AL
             NewState = EchoCreate();
         else if(effect->type == AL_EFFECT_RING_MODULATOR)
             NewState = ModulatorCreate();
+        else if(effect->type == AL_EFFECT_EQUALIZER)
+            NewState = EqualizerCreate();
+        else if(effect->type == AL_EFFECT_COMPRESSOR)
+            NewState = CompressorCreate();
+        else if(effect->type == AL_EFFECT_CHORUS)
+            NewState = ChorusCreate();
+        else if(effect->type == AL_EFFECT_FLANGER)
+            NewState = FlangerCreate();
         /* No new state? An error occured.. */
         if(NewState == NULL ||
            ALEffect_DeviceUpdate(NewState, Context->Device) == AL_FALSE)
@@ -506,6 +537,124 @@ static ALvoid InitializeEffect(ALCcontext *Context, ALeffectslot *EffectSlot, AL
     else
         memcpy(&EffectSlot->effect, effect, sizeof(*effect));
     ALEffect_Update(EffectSlot->EffectState, Context, effect);
+    UpdateSlotTail(EffectSlot);
+}
+
+/* Estimates how long the effect keeps producing output after its input goes
+ * silent, so the mixer can stop processing the slot once the tail is gone.
+ */
+static ALvoid UpdateSlotTail(ALeffectslot *EffectSlot)
+{
+    const ALeffect *effect = &EffectSlot->effect;
+
+    switch(effect->type)
+    {
+        case AL_EFFECT_NULL:
+            EffectSlot->TailGain = 0.0f;
+            EffectSlot->TailHold = 0.0f;
+            EffectSlot->TailDecay = 0.0f;
+            break;
+
+        case AL_EFFECT_REVERB:
+        case AL_EFFECT_EAXREVERB:
+            /* The tail holds for the initial delays, plus some time for the
+             * signal to work through the late lines, then decays by 60dB
+             * over the decay time. */
+            EffectSlot->TailGain = effect->Reverb.Gain *
+                                   __max(effect->Reverb.ReflectionsGain,
+                                         effect->Reverb.LateReverbGain);
+            EffectSlot->TailHold = effect->Reverb.ReflectionsDelay +
+                                   effect->Reverb.LateReverbDelay + 0.5f;
+            if(effect->type == AL_EFFECT_EAXREVERB)
+                EffectSlot->TailHold += effect->Reverb.EchoTime;
+            EffectSlot->TailDecay = effect->Reverb.DecayTime;
+            break;
+
+        case AL_EFFECT_ECHO: {
+            /* Each repeat comes after both taps and is attenuated by the
+             * feedback gain, so 60dB takes 3/-log10(feedback) repeats. */
+            ALfloat spacing = effect->Echo.Delay + effect->Echo.LRDelay;
+            EffectSlot->TailGain = 1.0f;
+            EffectSlot->TailHold = spacing;
+            EffectSlot->TailDecay = 0.0f;
+            if(effect->Echo.Feedback >= 1.0f)
+                EffectSlot->TailDecay = -1.0f;
+            else if(effect->Echo.Feedback > 0.0f)
+                EffectSlot->TailDecay = spacing * 3.0f /
+                                        -log10(effect->Echo.Feedback);
+        }   break;
+
+        case AL_EFFECT_RING_MODULATOR:
+            EffectSlot->TailGain = 1.0f;
+            EffectSlot->TailHold = 0.0f;
+            EffectSlot->TailDecay = 0.0f;
+            break;
+
+        case AL_EFFECT_EQUALIZER: {
+            /* The bands can boost the input, and a narrow peak rings for
+             * roughly 6.9*Q/(pi*f) seconds before dropping by 60dB. */
+            ALfloat q1 = 0.5f / sinh(log(2.0)/2.0 * effect->Equalizer.Mid1Width);
+            ALfloat q2 = 0.5f / sinh(log(2.0)/2.0 * effect->Equalizer.Mid2Width);
+            EffectSlot->TailGain = __max(effect->Equalizer.LowGain, 1.0f) *
+                                   __max(effect->Equalizer.Mid1Gain, 1.0f) *
+                                   __max(effect->Equalizer.Mid2Gain, 1.0f) *
+                                   __max(effect->Equalizer.HighGain, 1.0f);
+            EffectSlot->TailHold = 0.0f;
+            EffectSlot->TailDecay = __max(q1 / effect->Equalizer.Mid1Center,
+                                          q2 / effect->Equalizer.Mid2Center) *
+                                    6.9f / M_PI;
+            EffectSlot->TailDecay = __max(EffectSlot->TailDecay, 0.05f);
+        }   break;
+
+        case AL_EFFECT_COMPRESSOR:
+            /* Quieter signals are raised by the makeup gain (about 9dB), and
+             * the look-ahead holds back a few milliseconds of output. */
+            EffectSlot->TailGain = 3.0f;
+            EffectSlot->TailHold = 0.01f;
+            EffectSlot->TailDecay = 0.0f;
+            break;
+
+        case AL_EFFECT_CHORUS:
+        case AL_EFFECT_FLANGER: {
+            /* The longest the sweep can delay a sample is twice the center
+             * delay, and each pass back through is attenuated by the
+             * feedback gain. */
+            ALfloat spacing = effect->Chorus.Delay * 2.0f;
+            ALfloat feedback = aluFabs(effect->Chorus.Feedback);
+            EffectSlot->TailGain = 1.0f;
+            EffectSlot->TailHold = spacing;
+            EffectSlot->TailDecay = 0.0f;
+            if(feedback >= 1.0f)
+                EffectSlot->TailDecay = -1.0f;
+            else if(feedback > 0.0f)
+                EffectSlot->TailDecay = spacing * 3.0f / -log10(feedback);
+        }   break;
+
+        default:
+            // Unknown tail, never put the slot to sleep once it's fed
+            EffectSlot->TailGain = 1.0f;
+            EffectSlot->TailHold = 0.0f;
+            EffectSlot->TailDecay = -1.0f;
+            break;
+    }
+}
+
+/* Makes sure the context's active slot list can hold the given number of
+ * slots, so the mixer never needs to grow it.
+ */
+static ALboolean ReserveActiveEffectSlots(ALCcontext *Context, ALsizei count)
+{
+    ALeffectslot **temp;
+
+    if(count <= Context->MaxActiveEffectSlots)
+        return AL_TRUE;
+
+    temp = realloc(Context->ActiveEffectSlots, sizeof(*temp) * count);
+    if(!temp)
+        return AL_FALSE;
+    Context->ActiveEffectSlots = temp;
+    Context->MaxActiveEffectSlots = count;
+    return AL_TRUE;
 }
 
 
@@ -524,4 +673,141 @@ ALvoid ReleaseALAuxiliaryEffectSlots(ALCcontext *Context)
         memset(temp, 0, sizeof(ALeffectslot));
         free(temp);
     }
+    Context->ActiveEffectSlotCount = 0;
+}
+
+
+/* Delay line memory for the effects comes from a device-wide arena, so slots
+ * share a few large chunks instead of each holding separate allocations, and
+ * memory released by one slot can be reused by another. Allocations are
+ * rounded up to whole granules, and each chunk keeps its free spans sorted by
+ * address so neighbouring spans merge back together. A chunk is returned to
+ * the system as soon as nothing in it is in use.
+ */
+#define EFFECTMEM_GRANULE     16
+#define EFFECTMEM_CHUNK_SIZE  65536
+
+typedef struct EffectMemSpan {
+    ALuint Size;
+    struct EffectMemSpan *next;
+} EffectMemSpan;
+
+struct EffectMemChunk {
+    ALfloat *Samples;
+    ALuint Size;
+    // Free spans are stored in the unused samples themselves
+    EffectMemSpan *FreeList;
+
+    struct EffectMemChunk *next;
+};
+
+static __inline ALuint RoundToGranule(ALuint count)
+{
+    return (count+EFFECTMEM_GRANULE-1) & ~(EFFECTMEM_GRANULE-1);
+}
+
+ALfloat *AllocEffectSamples(ALCdevice *device, ALuint count)
+{
+    struct EffectMemChunk *chunk;
+    EffectMemSpan **span;
+    ALfloat *ret;
+
+    count = RoundToGranule(count);
+    if(count == 0)
+        return NULL;
+
+    for(chunk = device->EffectMem;chunk;chunk = chunk->next)
+    {
+        for(span = &chunk->FreeList;*span;span = &(*span)->next)
+        {
+            if((*span)->Size < count)
+                continue;
+
+            // Take it from the end of the span, so the span's header stays
+            // put
+            (*span)->Size -= count;
+            ret = (ALfloat*)(*span) + (*span)->Size;
+            if((*span)->Size == 0)
+                *span = (*span)->next;
+            return ret;
+        }
+    }
+
+    chunk = malloc(sizeof(*chunk));
+    if(!chunk)
+        return NULL;
+    chunk->Size = __max(count, EFFECTMEM_CHUNK_SIZE);
+    chunk->Samples = malloc(chunk->Size * sizeof(ALfloat));
+    if(!chunk->Samples)
+    {
+        free(chunk);
+        return NULL;
+    }
+    device->EffectMemBytes += chunk->Size * sizeof(ALfloat);
+
+    chunk->next = device->EffectMem;
+    device->EffectMem = chunk;
+
+    if(chunk->Size == count)
+    {
+        chunk->FreeList = NULL;
+        return chunk->Samples;
+    }
+    chunk->FreeList = (EffectMemSpan*)chunk->Samples;
+    chunk->FreeList->Size = chunk->Size - count;
+    chunk->FreeList->next = NULL;
+    return chunk->Samples + chunk->FreeList->Size;
+}
+
+ALvoid FreeEffectSamples(ALCdevice *device, ALfloat *samples, ALuint count)
+{
+    struct EffectMemChunk **chunk;
+    EffectMemSpan **span, *prev, *freed;
+
+    if(!samples)
+        return;
+    count = RoundToGranule(count);
+
+    chunk = &device->EffectMem;
+    while(*chunk && (samples < (*chunk)->Samples ||
+                     samples >= (*chunk)->Samples+(*chunk)->Size))
+        chunk = &(*chunk)->next;
+    if(!*chunk)
+        return;
+
+    // Find where it goes in the free list, merging with the spans on either
+    // side when they touch
+    prev = NULL;
+    span = &(*chunk)->FreeList;
+    while(*span && (ALfloat*)(*span) < samples)
+    {
+        prev = *span;
+        span = &(*span)->next;
+    }
+
+    if(prev && (ALfloat*)prev + prev->Size == samples)
+        prev->Size += count;
+    else
+    {
+        freed = (EffectMemSpan*)samples;
+        freed->Size = count;
+        freed->next = *span;
+        *span = freed;
+        prev = freed;
+    }
+    if(prev->next && (ALfloat*)prev + prev->Size == (ALfloat*)prev->next)
+    {
+        prev->Size += prev->next->Size;
+        prev->next = prev->next->next;
+    }
+
+    if((*chunk)->FreeList->Size == (*chunk)->Size)
+    {
+        struct EffectMemChunk *temp = *chunk;
+        *chunk = temp->next;
+
+        device->EffectMemBytes -= temp->Size * sizeof(ALfloat);
+        free(temp->Samples);
+        free(temp);
+    }
 }
@@ -24,6 +24,13 @@
 #include <stdio.h>
 #include <assert.h>
 #include <limits.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON
+#endif
 
 #include "alMain.h"
 #include "AL/al.h"
@@ -34,9 +41,15 @@
 #include "alThunk.h"
 
 
-static ALenum LoadData(ALbuffer *ALBuf, ALuint freq, ALenum NewFormat, ALsizei size, enum UserFmtChannels chans, enum UserFmtType type, const ALvoid *data);
-static void ConvertData(ALvoid *dst, enum FmtType dstType, const ALvoid *src, enum UserFmtType srcType, ALsizei len);
+static ALenum LoadData(ALbuffer *ALBuf, ALuint freq, ALenum NewFormat, ALsizei size, enum UserFmtChannels chans, enum UserFmtType type, const ALvoid *data, ALboolean dither);
+static void ConvertData(ALvoid *dst, enum FmtType dstType, const ALvoid *src, enum UserFmtType srcType, ALsizei len, ALboolean dither);
 static void ConvertDataIMA4(ALvoid *dst, enum FmtType dstType, const ALvoid *src, ALint chans, ALsizei len);
+static void FreeBufferData(ALbuffer *ALBuf);
+static ALuint HashBufferData(const ALvoid *data, ALsizei size);
+static void ShareBufferData(ALCdevice *device, ALbuffer *ALBuf, ALuint hash);
+static ALenum UnshareBufferData(ALbuffer *ALBuf);
+static ALenum StorageFormat(ALCdevice *device, ALenum format, enum UserFmtChannels chans, enum UserFmtType type, const ALvoid *data, ALsizei size);
+static ALenum QueueBufferJob(ALCdevice *device, ALbuffer *ALBuf, ALuint freq, ALenum format, ALsizei size, enum UserFmtChannels chans, enum UserFmtType type, const ALvoid *data);
 
 #define LookupBuffer(m, k) ((ALbuffer*)LookupUIntMapKey(&(m), (k)))
 
@@ -220,7 +233,7 @@ AL_API ALvoid AL_APIENTRY alDeleteBuffers(ALsizei n, const ALuint *buffers)
                 Failed = AL_TRUE;
                 break;
             }
-            else if(ALBuf->refcount != 0)
+            else if(ALBuf->refcount != 0 || ALBuf->Pending)
             {
                 /* Buffer still in use, cannot be deleted */
                 alSetError(Context, AL_INVALID_OPERATION);
@@ -240,7 +253,7 @@ AL_API ALvoid AL_APIENTRY alDeleteBuffers(ALsizei n, const ALuint *buffers)
                 continue;
 
             /* Release the memory used to store audio data */
-            free(ALBuf->data);
+            FreeBufferData(ALBuf);
 
             /* Release buffer structure */
             RemoveUIntMapKey(&device->BufferMap, ALBuf->buffer);
@@ -313,58 +326,205 @@ AL_API ALvoid AL_APIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid
         alSetError(Context, AL_INVALID_NAME);
     else if(ALBuf->refcount != 0)
         alSetError(Context, AL_INVALID_VALUE);
+    else if(ALBuf->Pending)
+        alSetError(Context, AL_INVALID_OPERATION);
     else if(size < 0 || freq < 0)
         alSetError(Context, AL_INVALID_VALUE);
     else if(DecomposeUserFormat(format, &SrcChannels, &SrcType) == AL_FALSE)
         alSetError(Context, AL_INVALID_ENUM);
-    else switch(SrcType)
+    else
     {
-        case UserFmtByte:
-        case UserFmtUByte:
-        case UserFmtShort:
-        case UserFmtUShort:
-        case UserFmtInt:
-        case UserFmtUInt:
-        case UserFmtFloat:
-            err = LoadData(ALBuf, freq, format, size, SrcChannels, SrcType, data);
-            if(err != AL_NO_ERROR)
-                alSetError(Context, err);
-            break;
+        err = LoadData(ALBuf, freq,
+                       StorageFormat(device, format, SrcChannels, SrcType, data, size),
+                       size, SrcChannels, SrcType, data, device->DitherBuffers);
+        if(err != AL_NO_ERROR)
+            alSetError(Context, err);
+        else if(device->ShareBuffers)
+            ShareBufferData(device, ALBuf, HashBufferData(ALBuf->data, ALBuf->size));
+    }
 
-        case UserFmtDouble: {
-            ALenum NewFormat = AL_FORMAT_MONO_FLOAT32;
-            switch(SrcChannels)
-            {
-                case UserFmtMono: NewFormat = AL_FORMAT_MONO_FLOAT32; break;
-                case UserFmtStereo: NewFormat = AL_FORMAT_STEREO_FLOAT32; break;
-                case UserFmtRear: NewFormat = AL_FORMAT_REAR32; break;
-                case UserFmtQuad: NewFormat = AL_FORMAT_QUAD32; break;
-                case UserFmtX51: NewFormat = AL_FORMAT_51CHN32; break;
-                case UserFmtX61: NewFormat = AL_FORMAT_61CHN32; break;
-                case UserFmtX71: NewFormat = AL_FORMAT_71CHN32; break;
-            }
-            err = LoadData(ALBuf, freq, NewFormat, size, SrcChannels, SrcType, data);
-            if(err != AL_NO_ERROR)
-                alSetError(Context, err);
-        }   break;
+    ProcessContext(Context);
+}
 
-        case UserFmtMulaw:
-        case UserFmtIMA4: {
-            ALenum NewFormat = AL_FORMAT_MONO16;
-            switch(SrcChannels)
-            {
-                case UserFmtMono: NewFormat = AL_FORMAT_MONO16; break;
-                case UserFmtStereo: NewFormat = AL_FORMAT_STEREO16; break;
-                case UserFmtRear: NewFormat = AL_FORMAT_REAR16; break;
-                case UserFmtQuad: NewFormat = AL_FORMAT_QUAD16; break;
-                case UserFmtX51: NewFormat = AL_FORMAT_51CHN16; break;
-                case UserFmtX61: NewFormat = AL_FORMAT_61CHN16; break;
-                case UserFmtX71: NewFormat = AL_FORMAT_71CHN16; break;
-            }
-            err = LoadData(ALBuf, freq, NewFormat, size, SrcChannels, SrcType, data);
+/*
+ *    alBufferDataStatic(ALint buffer, ALenum format, ALvoid *data,
+ *                       ALsizei size, ALsizei freq)
+ *
+ *    Fill buffer with audio data, referencing the app's memory directly
+ *    instead of copying it. The format must be one the mixer can use as-is
+ *    (8-bit unsigned, 16-bit signed or 32-bit float). The memory must remain
+ *    valid until the buffer is deleted or given new data, which can only
+ *    happen once no source is using it. With a sample source databuffer
+ *    selected, data is an offset into it and the databuffer is kept alive
+ *    by the buffer instead.
+ */
+AL_API ALvoid AL_APIENTRY alBufferDataStatic(const ALint buffer,ALenum format,ALvoid *data,ALsizei size,ALsizei freq)
+{
+    enum UserFmtChannels SrcChannels;
+    enum UserFmtType SrcType;
+    ALCcontext *Context;
+    ALdatabuffer *DataBuf;
+    ALCdevice *device;
+    ALbuffer *ALBuf;
+    ALuint FrameSize;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    if((DataBuf=Context->SampleSource) != NULL)
+    {
+        ALintptrEXT offset;
+
+        if(DataBuf->state == MAPPED)
+        {
+            alSetError(Context, AL_INVALID_OPERATION);
+            ProcessContext(Context);
+            return;
+        }
+
+        offset = (const ALubyte*)data - (ALubyte*)NULL;
+        if(offset < 0 || size < 0 || offset > DataBuf->size ||
+           size > DataBuf->size-offset)
+        {
+            alSetError(Context, AL_INVALID_VALUE);
+            ProcessContext(Context);
+            return;
+        }
+        data = DataBuf->data + offset;
+    }
+
+    device = Context->Device;
+    if((ALBuf=LookupBuffer(device->BufferMap, (ALuint)buffer)) == NULL)
+        alSetError(Context, AL_INVALID_NAME);
+    else if(ALBuf->refcount != 0)
+        alSetError(Context, AL_INVALID_VALUE);
+    else if(ALBuf->Pending)
+        alSetError(Context, AL_INVALID_OPERATION);
+    else if(size < 0 || freq < 0 || (size > 0 && data == NULL))
+        alSetError(Context, AL_INVALID_VALUE);
+    else if(DecomposeUserFormat(format, &SrcChannels, &SrcType) == AL_FALSE)
+        alSetError(Context, AL_INVALID_ENUM);
+    else if(SrcType != (enum UserFmtType)FmtUByte &&
+            SrcType != (enum UserFmtType)FmtShort &&
+            SrcType != (enum UserFmtType)FmtFloat)
+        alSetError(Context, AL_INVALID_ENUM);
+    else if((size%(FrameSize=FrameSizeFromUserFmt(SrcChannels, SrcType))) != 0)
+        alSetError(Context, AL_INVALID_VALUE);
+    else
+    {
+        FreeBufferData(ALBuf);
+        ALBuf->data = data;
+        ALBuf->size = size;
+        ALBuf->StaticData = AL_TRUE;
+        if((ALBuf->Databuffer=DataBuf) != NULL)
+            DataBuf->refcount++;
+
+        ALBuf->OriginalChannels = SrcChannels;
+        ALBuf->OriginalType     = SrcType;
+        ALBuf->OriginalSize     = size;
+        ALBuf->OriginalAlign    = FrameSize;
+
+        ALBuf->Frequency = freq;
+        ALBuf->FmtChannels = (enum FmtChannels)SrcChannels;
+        ALBuf->FmtType = (enum FmtType)SrcType;
+
+        ALBuf->LoopStart = 0;
+        ALBuf->LoopEnd = size / FrameSize;
+    }
+
+    ProcessContext(Context);
+}
+
+/*
+ *    alBufferDataAsyncSOFT(ALuint buffer, ALenum format, const ALvoid *data,
+ *                          ALsizei size, ALsizei freq)
+ *
+ *    Like alBufferData, but the conversion is done by a background thread
+ *    and this returns immediately. data must remain valid until the upload
+ *    completes. Until then the buffer is pending: it can't be attached to a
+ *    source, modified, or deleted. Completion can be polled with
+ *    AL_BUFFER_PENDING_SOFT or waited on with alWaitBufferSOFT.
+ */
+AL_API ALvoid AL_APIENTRY alBufferDataAsyncSOFT(ALuint buffer,ALenum format,const ALvoid *data,ALsizei size,ALsizei freq)
+{
+    enum UserFmtChannels SrcChannels;
+    enum UserFmtType SrcType;
+    ALCcontext *Context;
+    ALCdevice *device;
+    ALbuffer *ALBuf;
+    ALuint align;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    device = Context->Device;
+    if(Context->SampleSource)
+        alSetError(Context, AL_INVALID_OPERATION);
+    else if((ALBuf=LookupBuffer(device->BufferMap, buffer)) == NULL)
+        alSetError(Context, AL_INVALID_NAME);
+    else if(ALBuf->refcount != 0)
+        alSetError(Context, AL_INVALID_VALUE);
+    else if(ALBuf->Pending)
+        alSetError(Context, AL_INVALID_OPERATION);
+    else if(size < 0 || freq < 0 || (size > 0 && data == NULL))
+        alSetError(Context, AL_INVALID_VALUE);
+    else if(DecomposeUserFormat(format, &SrcChannels, &SrcType) == AL_FALSE)
+        alSetError(Context, AL_INVALID_ENUM);
+    else
+    {
+        /* Catch what LoadData would reject now, since the worker has no
+         * context to report it on */
+        align = ((SrcType == UserFmtIMA4) ? 36*ChannelsFromUserFmt(SrcChannels) :
+                 FrameSizeFromUserFmt(SrcChannels, SrcType));
+        if((size%align) != 0)
+            alSetError(Context, AL_INVALID_VALUE);
+        else
+        {
+            ALenum err = QueueBufferJob(device, ALBuf, freq, format, size,
+                                        SrcChannels, SrcType, data);
             if(err != AL_NO_ERROR)
                 alSetError(Context, err);
-        }   break;
+        }
+    }
+
+    ProcessContext(Context);
+}
+
+/*
+ *    alWaitBufferSOFT(ALuint buffer)
+ *
+ *    Blocks until any async upload for the buffer completes, and reports an
+ *    error if the upload failed.
+ */
+AL_API ALvoid AL_APIENTRY alWaitBufferSOFT(ALuint buffer)
+{
+    ALCcontext *Context;
+    ALCdevice *device;
+    ALbuffer *ALBuf;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    device = Context->Device;
+    if((ALBuf=LookupBuffer(device->BufferMap, buffer)) == NULL)
+        alSetError(Context, AL_INVALID_NAME);
+    else
+    {
+        /* The buffer can't be deleted while pending, so it stays valid while
+         * the lock is released for the worker to finish. The worker posts
+         * once for each waiter after every job, so recheck on each wake */
+        while(ALBuf->Pending)
+        {
+            device->BufferWaiters++;
+            ProcessContext(Context);
+            WaitSem(device->BufferDoneSem);
+            SuspendContext(Context);
+        }
+        if(ALBuf->AsyncError != AL_NO_ERROR)
+        {
+            alSetError(Context, ALBuf->AsyncError);
+            ALBuf->AsyncError = AL_NO_ERROR;
+        }
     }
 
     ProcessContext(Context);
@@ -383,6 +543,7 @@ AL_API ALvoid AL_APIENTRY alBufferSubDataSOFT(ALuint buffer,ALenum format,const
     ALCcontext *Context;
     ALCdevice  *device;
     ALbuffer   *ALBuf;
+    ALenum      err;
 
     Context = GetContextSuspended();
     if(!Context) return;
@@ -405,6 +566,8 @@ AL_API ALvoid AL_APIENTRY alBufferSubDataSOFT(ALuint buffer,ALenum format,const
     device = Context->Device;
     if((ALBuf=LookupBuffer(device->BufferMap, buffer)) == NULL)
         alSetError(Context, AL_INVALID_NAME);
+    else if(ALBuf->Pending)
+        alSetError(Context, AL_INVALID_OPERATION);
     else if(length < 0 || offset < 0 || (length > 0 && data == NULL))
         alSetError(Context, AL_INVALID_VALUE);
     else if(DecomposeUserFormat(format, &SrcChannels, &SrcType) == AL_FALSE ||
@@ -416,6 +579,8 @@ AL_API ALvoid AL_APIENTRY alBufferSubDataSOFT(ALuint buffer,ALenum format,const
             (offset%ALBuf->OriginalAlign) != 0 ||
             (length%ALBuf->OriginalAlign) != 0)
         alSetError(Context, AL_INVALID_VALUE);
+    else if((err=UnshareBufferData(ALBuf)) != AL_NO_ERROR)
+        alSetError(Context, err);
     else
     {
         if(SrcType == UserFmtIMA4)
@@ -442,7 +607,7 @@ AL_API ALvoid AL_APIENTRY alBufferSubDataSOFT(ALuint buffer,ALenum format,const
             length /= OldBytes;
 
             ConvertData(&((ALubyte*)ALBuf->data)[offset], ALBuf->FmtType,
-                        data, SrcType, length);
+                        data, SrcType, length, device->DitherBuffers);
         }
     }
 
@@ -608,7 +773,7 @@ AL_API void AL_APIENTRY alBufferiv(ALuint buffer, ALenum eParam, const ALint* pl
         switch(eParam)
         {
         case AL_LOOP_POINTS_SOFT:
-            if(ALBuf->refcount > 0)
+            if(ALBuf->refcount > 0 || ALBuf->Pending)
                 alSetError(pContext, AL_INVALID_OPERATION);
             else if(plValues[0] < 0 || plValues[1] < 0 ||
                     plValues[0] >= plValues[1] || ALBuf->size == 0)
@@ -752,6 +917,10 @@ AL_API ALvoid AL_APIENTRY alGetBufferi(ALuint buffer, ALenum eParam, ALint *plVa
             *plValue = pBuffer->size;
             break;
 
+        case AL_BUFFER_PENDING_SOFT:
+            *plValue = pBuffer->Pending;
+            break;
+
         default:
             alSetError(pContext, AL_INVALID_ENUM);
             break;
@@ -811,6 +980,7 @@ AL_API void AL_APIENTRY alGetBufferiv(ALuint buffer, ALenum eParam, ALint* plVal
         case AL_BITS:
         case AL_CHANNELS:
         case AL_SIZE:
+        case AL_BUFFER_PENDING_SOFT:
             alGetBufferi(buffer, eParam, plValues);
             break;
 
@@ -1228,11 +1398,9 @@ DECL_TEMPLATE(ALubyte, ALmulaw)
 
 DECL_TEMPLATE(ALshort, ALbyte)
 DECL_TEMPLATE(ALshort, ALubyte)
-DECL_TEMPLATE(ALshort, ALshort)
 DECL_TEMPLATE(ALshort, ALushort)
 DECL_TEMPLATE(ALshort, ALint)
 DECL_TEMPLATE(ALshort, ALuint)
-DECL_TEMPLATE(ALshort, ALfloat)
 DECL_TEMPLATE(ALshort, ALdouble)
 DECL_TEMPLATE(ALshort, ALmulaw)
 
@@ -1268,12 +1436,9 @@ DECL_TEMPLATE(ALuint, ALmulaw)
 
 DECL_TEMPLATE(ALfloat, ALbyte)
 DECL_TEMPLATE(ALfloat, ALubyte)
-DECL_TEMPLATE(ALfloat, ALshort)
 DECL_TEMPLATE(ALfloat, ALushort)
 DECL_TEMPLATE(ALfloat, ALint)
 DECL_TEMPLATE(ALfloat, ALuint)
-DECL_TEMPLATE(ALfloat, ALfloat)
-DECL_TEMPLATE(ALfloat, ALdouble)
 DECL_TEMPLATE(ALfloat, ALmulaw)
 
 DECL_TEMPLATE(ALdouble, ALbyte)
@@ -1298,6 +1463,126 @@ DECL_TEMPLATE(ALmulaw, ALmulaw)
 
 #undef DECL_TEMPLATE
 
+/* Specialized versions of the most common conversions, which LoadData and
+ * alBufferSubDataSOFT spend most of their time in. These must give the same
+ * results as the generic ones above. */
+static void Convert_ALshort_ALshort(ALshort *dst, const ALshort *src, ALuint len)
+{ memcpy(dst, src, len*sizeof(ALshort)); }
+static void Convert_ALfloat_ALfloat(ALfloat *dst, const ALfloat *src, ALuint len)
+{ memcpy(dst, src, len*sizeof(ALfloat)); }
+
+static void Convert_ALshort_ALfloat(ALshort *dst, const ALfloat *src, ALuint len)
+{
+    ALuint i = 0;
+#if defined(USE_SSE2)
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    for(;i+8 <= len;i += 8)
+    {
+        __m128 v0 = _mm_loadu_ps(&src[i]);
+        __m128 v1 = _mm_loadu_ps(&src[i+4]);
+        /* Values below -1 map to -32768, so add the all-ones compare mask
+         * (-1) to the clamped -32767 */
+        __m128i m0 = _mm_castps_si128(_mm_cmplt_ps(v0, lo));
+        __m128i m1 = _mm_castps_si128(_mm_cmplt_ps(v1, lo));
+        __m128i i0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(v0, lo), hi), scale));
+        __m128i i1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(v1, lo), hi), scale));
+        i0 = _mm_add_epi32(i0, m0);
+        i1 = _mm_add_epi32(i1, m1);
+        _mm_storeu_si128((__m128i*)&dst[i], _mm_packs_epi32(i0, i1));
+    }
+#elif defined(USE_NEON)
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    for(;i+8 <= len;i += 8)
+    {
+        float32x4_t v0 = vld1q_f32(&src[i]);
+        float32x4_t v1 = vld1q_f32(&src[i+4]);
+        int32x4_t m0 = vreinterpretq_s32_u32(vcltq_f32(v0, lo));
+        int32x4_t m1 = vreinterpretq_s32_u32(vcltq_f32(v1, lo));
+        int32x4_t i0 = vcvtq_s32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(v0, lo), hi), 32767.0f));
+        int32x4_t i1 = vcvtq_s32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(v1, lo), hi), 32767.0f));
+        i0 = vaddq_s32(i0, m0);
+        i1 = vaddq_s32(i1, m1);
+        vst1q_s16(&dst[i], vcombine_s16(vqmovn_s32(i0), vqmovn_s32(i1)));
+    }
+#endif
+    for(;i < len;i++)
+        dst[i] = Conv_ALshort_ALfloat(src[i]);
+}
+
+static void Convert_ALfloat_ALshort(ALfloat *dst, const ALshort *src, ALuint len)
+{
+    ALuint i = 0;
+#if defined(USE_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f/32767.0f);
+    for(;i+8 <= len;i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)&src[i]);
+        /* Sign-extend each half to 32-bit */
+        __m128i i0 = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i i1 = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(&dst[i],   _mm_mul_ps(_mm_cvtepi32_ps(i0), scale));
+        _mm_storeu_ps(&dst[i+4], _mm_mul_ps(_mm_cvtepi32_ps(i1), scale));
+    }
+#elif defined(USE_NEON)
+    for(;i+8 <= len;i += 8)
+    {
+        int16x8_t v = vld1q_s16(&src[i]);
+        int32x4_t i0 = vmovl_s16(vget_low_s16(v));
+        int32x4_t i1 = vmovl_s16(vget_high_s16(v));
+        vst1q_f32(&dst[i],   vmulq_n_f32(vcvtq_f32_s32(i0), 1.0f/32767.0f));
+        vst1q_f32(&dst[i+4], vmulq_n_f32(vcvtq_f32_s32(i1), 1.0f/32767.0f));
+    }
+#endif
+    for(;i < len;i++)
+        dst[i] = Conv_ALfloat_ALshort(src[i]);
+}
+
+static void Convert_ALfloat_ALdouble(ALfloat *dst, const ALdouble *src, ALuint len)
+{
+    ALuint i = 0;
+#if defined(USE_SSE2)
+    for(;i+4 <= len;i += 4)
+    {
+        __m128 v0 = _mm_cvtpd_ps(_mm_loadu_pd(&src[i]));
+        __m128 v1 = _mm_cvtpd_ps(_mm_loadu_pd(&src[i+2]));
+        _mm_storeu_ps(&dst[i], _mm_movelh_ps(v0, v1));
+    }
+#endif
+    for(;i < len;i++)
+        dst[i] = Conv_ALfloat_ALdouble(src[i]);
+}
+
+/* Float to 16-bit with triangular (TPDF) dither, for buffers stored as 16-bit
+ * when buffer-dither is set. This rounds rather than truncates, since the
+ * dither takes care of decorrelating the quantization error. */
+#define DECL_TEMPLATE(T)                                                      \
+static void Dither_ALshort_##T(ALshort *dst, const T *src, ALuint len)        \
+{                                                                             \
+    ALuint seed = 22222;                                                      \
+    ALfloat r1, r2, val;                                                      \
+    ALuint i;                                                                 \
+    for(i = 0;i < len;i++)                                                    \
+    {                                                                         \
+        seed = seed*96314165 + 907633515;                                     \
+        r1 = (seed>>8) * (1.0f/16777216.0f);                                  \
+        seed = seed*96314165 + 907633515;                                     \
+        r2 = (seed>>8) * (1.0f/16777216.0f);                                  \
+                                                                              \
+        val = (ALfloat)src[i]*32767.0f + (r1-r2);                             \
+        if(val >= 32767.0f) dst[i] = 32767;                                   \
+        else if(val <= -32768.0f) dst[i] = -32768;                            \
+        else dst[i] = (ALint)(val + 32768.5f) - 32768;                        \
+    }                                                                         \
+}
+
+DECL_TEMPLATE(ALfloat)
+DECL_TEMPLATE(ALdouble)
+
+#undef DECL_TEMPLATE
+
 #define DECL_TEMPLATE(T)                                                      \
 static void Convert_##T##_IMA4(T *dst, const ALubyte *src, ALuint numchans,   \
                                ALuint numblocks)                              \
@@ -1449,8 +1734,22 @@ static void Convert_IMA4(ALubyte *dst, const ALvoid *src, enum UserFmtType srcTy
 }
 
 
-static void ConvertData(ALvoid *dst, enum FmtType dstType, const ALvoid *src, enum UserFmtType srcType, ALsizei len)
+static void ConvertData(ALvoid *dst, enum FmtType dstType, const ALvoid *src, enum UserFmtType srcType, ALsizei len, ALboolean dither)
 {
+    if(dither && dstType == FmtShort)
+    {
+        if(srcType == UserFmtFloat)
+        {
+            Dither_ALshort_ALfloat(dst, src, len);
+            return;
+        }
+        if(srcType == UserFmtDouble)
+        {
+            Dither_ALshort_ALdouble(dst, src, len);
+            return;
+        }
+    }
+
     switch(dstType)
     {
         (void)Convert_ALbyte;
@@ -1495,6 +1794,404 @@ static void ConvertDataIMA4(ALvoid *dst, enum FmtType dstType, const ALvoid *src
 }
 
 
+/*
+ * StorageFormat
+ *
+ * Returns the format LoadData stores data of the given input format as.
+ * Float data is stored as 16-bit if the device's buffer-storage option asks
+ * for it.
+ */
+static ALboolean FitsInShort(const ALvoid *data, ALsizei size, enum UserFmtType type)
+{
+    ALsizei i;
+
+    if(type == UserFmtFloat)
+    {
+        const ALfloat *samples = data;
+        for(i = 0;i < size/(ALsizei)sizeof(ALfloat);i++)
+        {
+            if(samples[i] > 1.0f || samples[i] < -1.0f)
+                return AL_FALSE;
+        }
+    }
+    else if(type == UserFmtDouble)
+    {
+        const ALdouble *samples = data;
+        for(i = 0;i < size/(ALsizei)sizeof(ALdouble);i++)
+        {
+            if(samples[i] > 1.0 || samples[i] < -1.0)
+                return AL_FALSE;
+        }
+    }
+    return AL_TRUE;
+}
+
+static ALenum StorageFormat(ALCdevice *device, ALenum format, enum UserFmtChannels SrcChannels, enum UserFmtType SrcType, const ALvoid *data, ALsizei size)
+{
+    static const ALenum FloatFormats[] = {
+        AL_FORMAT_MONO_FLOAT32, AL_FORMAT_STEREO_FLOAT32, AL_FORMAT_REAR32,
+        AL_FORMAT_QUAD32, AL_FORMAT_51CHN32, AL_FORMAT_61CHN32,
+        AL_FORMAT_71CHN32
+    };
+    static const ALenum ShortFormats[] = {
+        AL_FORMAT_MONO16, AL_FORMAT_STEREO16, AL_FORMAT_REAR16,
+        AL_FORMAT_QUAD16, AL_FORMAT_51CHN16, AL_FORMAT_61CHN16,
+        AL_FORMAT_71CHN16
+    };
+
+    switch(SrcType)
+    {
+        case UserFmtByte:
+        case UserFmtUByte:
+        case UserFmtShort:
+        case UserFmtUShort:
+        case UserFmtInt:
+        case UserFmtUInt:
+            return format;
+
+        case UserFmtFloat:
+        case UserFmtDouble:
+            if(device->BufferStorage == BufferStorageShort ||
+               (device->BufferStorage == BufferStorageAuto && data != NULL &&
+                FitsInShort(data, size, SrcType)))
+                return ShortFormats[SrcChannels];
+            return FloatFormats[SrcChannels];
+
+        case UserFmtMulaw:
+        case UserFmtIMA4:
+            return ShortFormats[SrcChannels];
+    }
+    return format;
+}
+
+
+/*
+ * Async buffer uploads
+ *
+ * Jobs are queued on the device and converted by a worker thread into
+ * separate storage without holding the lock. The result is swapped into
+ * the buffer under the lock, after which it is no longer pending.
+ */
+typedef struct ALbufferJob {
+    ALbuffer *buffer;
+    ALuint freq;
+    ALenum format;
+    ALsizei size;
+    enum UserFmtChannels SrcChannels;
+    enum UserFmtType SrcType;
+    const ALvoid *data;
+
+    struct ALbufferJob *next;
+} ALbufferJob;
+
+/* Wakes every alWaitBufferSOFT caller to recheck its buffer. Must be called
+ * with the lock held. */
+static ALvoid WakeBufferWaiters(ALCdevice *device)
+{
+    for(;device->BufferWaiters > 0;device->BufferWaiters--)
+        PostSem(device->BufferDoneSem);
+}
+
+static ALuint BufferThreadProc(ALvoid *ptr)
+{
+    ALCdevice *device = (ALCdevice*)ptr;
+
+    while(1)
+    {
+        ALbufferJob *job;
+        ALbuffer temp;
+        ALuint hash = 0;
+        ALenum err;
+
+        WaitSem(device->BufferJobSem);
+        if(device->KillBufferThread)
+            break;
+
+        SuspendContext(NULL);
+        if((job=device->BufferJobs) != NULL)
+            device->BufferJobs = job->next;
+        ProcessContext(NULL);
+
+        if(!job)
+            continue;
+
+        memset(&temp, 0, sizeof(temp));
+        err = LoadData(&temp, job->freq,
+                       StorageFormat(device, job->format, job->SrcChannels,
+                                     job->SrcType, job->data, job->size),
+                       job->size, job->SrcChannels, job->SrcType, job->data,
+                       device->DitherBuffers);
+        if(err == AL_NO_ERROR && device->ShareBuffers)
+            hash = HashBufferData(temp.data, temp.size);
+
+        SuspendContext(NULL);
+        if(err == AL_NO_ERROR)
+        {
+            ALbuffer *ALBuf = job->buffer;
+
+            FreeBufferData(ALBuf);
+            ALBuf->data = temp.data;
+            ALBuf->size = temp.size;
+            ALBuf->Frequency = temp.Frequency;
+            ALBuf->FmtChannels = temp.FmtChannels;
+            ALBuf->FmtType = temp.FmtType;
+            ALBuf->OriginalChannels = temp.OriginalChannels;
+            ALBuf->OriginalType = temp.OriginalType;
+            ALBuf->OriginalSize = temp.OriginalSize;
+            ALBuf->OriginalAlign = temp.OriginalAlign;
+            ALBuf->LoopStart = temp.LoopStart;
+            ALBuf->LoopEnd = temp.LoopEnd;
+
+            if(device->ShareBuffers)
+                ShareBufferData(device, ALBuf, hash);
+        }
+        job->buffer->AsyncError = err;
+        job->buffer->Pending = AL_FALSE;
+        WakeBufferWaiters(device);
+        ProcessContext(NULL);
+
+        free(job);
+    }
+
+    return 0;
+}
+
+static ALvoid DestroyBufferSems(ALCdevice *device)
+{
+    if(device->BufferJobSem)
+        DestroySem(device->BufferJobSem);
+    if(device->BufferDoneSem)
+        DestroySem(device->BufferDoneSem);
+    device->BufferJobSem = NULL;
+    device->BufferDoneSem = NULL;
+}
+
+static ALenum QueueBufferJob(ALCdevice *device, ALbuffer *ALBuf, ALuint freq, ALenum format, ALsizei size, enum UserFmtChannels SrcChannels, enum UserFmtType SrcType, const ALvoid *data)
+{
+    ALbufferJob *job, **list;
+
+    if(!device->BufferThread)
+    {
+        device->BufferJobSem = CreateSem(0);
+        device->BufferDoneSem = CreateSem(0);
+        device->BufferWaiters = 0;
+        device->KillBufferThread = AL_FALSE;
+        if(device->BufferJobSem && device->BufferDoneSem)
+            device->BufferThread = StartThread(BufferThreadProc, device);
+        if(!device->BufferThread)
+        {
+            DestroyBufferSems(device);
+            return AL_OUT_OF_MEMORY;
+        }
+    }
+
+    job = malloc(sizeof(ALbufferJob));
+    if(!job) return AL_OUT_OF_MEMORY;
+
+    job->buffer = ALBuf;
+    job->freq = freq;
+    job->format = format;
+    job->size = size;
+    job->SrcChannels = SrcChannels;
+    job->SrcType = SrcType;
+    job->data = data;
+    job->next = NULL;
+
+    list = &device->BufferJobs;
+    while(*list)
+        list = &(*list)->next;
+    *list = job;
+
+    ALBuf->AsyncError = AL_NO_ERROR;
+    ALBuf->Pending = AL_TRUE;
+    PostSem(device->BufferJobSem);
+
+    return AL_NO_ERROR;
+}
+
+/*
+ *    StopBufferThread()
+ *
+ *    INTERNAL: Called when closing the device to stop the async upload
+ *    thread, dropping any uploads it hasn't started
+ */
+ALvoid StopBufferThread(ALCdevice *device)
+{
+    ALbufferJob *job;
+
+    if(device->BufferThread)
+    {
+        device->KillBufferThread = AL_TRUE;
+        PostSem(device->BufferJobSem);
+        StopThread(device->BufferThread);
+        device->BufferThread = NULL;
+    }
+
+    while((job=device->BufferJobs) != NULL)
+    {
+        device->BufferJobs = job->next;
+        job->buffer->Pending = AL_FALSE;
+        free(job);
+    }
+    DestroyBufferSems(device);
+}
+
+
+/*
+ * FreeBufferData
+ *
+ * Releases the buffer's sample storage. Static data is only dereferenced,
+ * since the memory belongs to the app (or a databuffer), and shared storage
+ * is only freed by its last user.
+ */
+static void FreeBufferData(ALbuffer *ALBuf)
+{
+    if(ALBuf->Store)
+    {
+        ALbufferStore *store = ALBuf->Store;
+        if(--store->refcount == 0)
+        {
+            *(store->prev) = store->next;
+            if(store->next)
+                store->next->prev = store->prev;
+            free(store->data);
+            free(store);
+        }
+        ALBuf->Store = NULL;
+    }
+    else if(ALBuf->StaticData)
+    {
+        if(ALBuf->Databuffer)
+            ALBuf->Databuffer->refcount--;
+        ALBuf->Databuffer = NULL;
+        ALBuf->StaticData = AL_FALSE;
+    }
+    else
+        free(ALBuf->data);
+    ALBuf->data = NULL;
+    ALBuf->size = 0;
+}
+
+static __inline ALboolean OwnsBufferData(const ALbuffer *ALBuf)
+{ return !ALBuf->StaticData && !ALBuf->Store; }
+
+
+/*
+ * Buffer storage sharing
+ *
+ * With dedup-buffers enabled, freshly loaded data is hashed and looked up
+ * among the device's stores. A match with the same format and frequency is
+ * referenced instead of keeping a second copy. Writes go through
+ * UnshareBufferData first, so sharing is never visible to the app.
+ */
+static ALuint HashBufferData(const ALvoid *data, ALsizei size)
+{
+    const ALubyte *bytes = data;
+    ALuint hash = 2166136261u;
+    ALsizei i;
+
+    /* FNV-1a */
+    for(i = 0;i < size;i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void ShareBufferData(ALCdevice *device, ALbuffer *ALBuf, ALuint hash)
+{
+    ALbufferStore *store;
+
+    if(!OwnsBufferData(ALBuf) || ALBuf->size == 0)
+        return;
+
+    for(store = device->BufferStores;store;store = store->next)
+    {
+        if(store->hash == hash && store->size == ALBuf->size &&
+           store->Frequency == ALBuf->Frequency &&
+           store->FmtChannels == ALBuf->FmtChannels &&
+           store->FmtType == ALBuf->FmtType &&
+           memcmp(store->data, ALBuf->data, store->size) == 0)
+        {
+            free(ALBuf->data);
+            ALBuf->data = store->data;
+            ALBuf->Store = store;
+            store->refcount++;
+            return;
+        }
+    }
+
+    /* No match, so this buffer's data becomes a new store others can use.
+     * If that fails, the buffer just keeps its own copy. */
+    store = malloc(sizeof(ALbufferStore));
+    if(!store) return;
+
+    store->data = ALBuf->data;
+    store->size = ALBuf->size;
+    store->Frequency = ALBuf->Frequency;
+    store->FmtChannels = ALBuf->FmtChannels;
+    store->FmtType = ALBuf->FmtType;
+    store->hash = hash;
+    store->refcount = 1;
+
+    store->next = device->BufferStores;
+    store->prev = &device->BufferStores;
+    if(store->next)
+        store->next->prev = &store->next;
+    device->BufferStores = store;
+
+    ALBuf->Store = store;
+}
+
+static ALenum UnshareBufferData(ALbuffer *ALBuf)
+{
+    ALbufferStore *store = ALBuf->Store;
+    ALvoid *temp;
+
+    if(!store)
+        return AL_NO_ERROR;
+
+    if(store->refcount == 1)
+    {
+        /* Sole user; take the data back and drop the store */
+        *(store->prev) = store->next;
+        if(store->next)
+            store->next->prev = store->prev;
+        free(store);
+        ALBuf->Store = NULL;
+        return AL_NO_ERROR;
+    }
+
+    temp = malloc(store->size);
+    if(!temp) return AL_OUT_OF_MEMORY;
+    memcpy(temp, store->data, store->size);
+
+    store->refcount--;
+    ALBuf->Store = NULL;
+    ALBuf->data = temp;
+    return AL_NO_ERROR;
+}
+
+/*
+ *    BufferStoreBytesSaved()
+ *
+ *    INTERNAL: Returns how many bytes of sample data are not duplicated
+ *    thanks to storage sharing
+ */
+ALsizei BufferStoreBytesSaved(ALCdevice *device)
+{
+    ALbufferStore *store;
+    ALuint64 saved = 0;
+
+    for(store = device->BufferStores;store;store = store->next)
+        saved += (ALuint64)(store->refcount-1) * store->size;
+
+    return (ALsizei)min(saved, INT_MAX);
+}
+
+
+
 /*
  * LoadData
  *
@@ -1502,7 +2199,7 @@ static void ConvertDataIMA4(ALvoid *dst, enum FmtType dstType, const ALvoid *src
  * Currently, the new format must have the same channel configuration as the
  * original format.
  */
-static ALenum LoadData(ALbuffer *ALBuf, ALuint freq, ALenum NewFormat, ALsizei size, enum UserFmtChannels SrcChannels, enum UserFmtType SrcType, const ALvoid *data)
+static ALenum LoadData(ALbuffer *ALBuf, ALuint freq, ALenum NewFormat, ALsizei size, enum UserFmtChannels SrcChannels, enum UserFmtType SrcType, const ALvoid *data, ALboolean dither)
 {
     ALuint NewChannels, NewBytes;
     enum FmtChannels DstChannels;
@@ -1533,8 +2230,11 @@ static ALenum LoadData(ALbuffer *ALBuf, ALuint freq, ALenum NewFormat, ALsizei s
         if(newsize > INT_MAX)
             return AL_OUT_OF_MEMORY;
 
-        temp = realloc(ALBuf->data, newsize);
+        /* Static or shared data isn't ours to resize in place */
+        temp = realloc((OwnsBufferData(ALBuf) ? ALBuf->data : NULL), newsize);
         if(!temp && newsize) return AL_OUT_OF_MEMORY;
+        if(!OwnsBufferData(ALBuf))
+            FreeBufferData(ALBuf);
         ALBuf->data = temp;
         ALBuf->size = newsize;
 
@@ -1560,13 +2260,17 @@ static ALenum LoadData(ALbuffer *ALBuf, ALuint freq, ALenum NewFormat, ALsizei s
         if(newsize > INT_MAX)
             return AL_OUT_OF_MEMORY;
 
-        temp = realloc(ALBuf->data, newsize);
+        /* Static or shared data isn't ours to resize in place */
+        temp = realloc((OwnsBufferData(ALBuf) ? ALBuf->data : NULL), newsize);
         if(!temp && newsize) return AL_OUT_OF_MEMORY;
+        if(!OwnsBufferData(ALBuf))
+            FreeBufferData(ALBuf);
         ALBuf->data = temp;
         ALBuf->size = newsize;
 
         if(data != NULL)
-            ConvertData(ALBuf->data, DstType, data, SrcType, newsize/NewBytes);
+            ConvertData(ALBuf->data, DstType, data, SrcType, newsize/NewBytes,
+                        dither);
 
         ALBuf->OriginalChannels = SrcChannels;
         ALBuf->OriginalType     = SrcType;
@@ -1887,7 +2591,7 @@ ALvoid ReleaseALBuffers(ALCdevice *device)
         ALbuffer *temp = device->BufferMap.array[i].value;
         device->BufferMap.array[i].value = NULL;
 
-        free(temp->data);
+        FreeBufferData(temp);
 
         ALTHUNK_REMOVEENTRY(temp->buffer);
         memset(temp, 0, sizeof(ALbuffer));
@@ -23,6 +23,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include "alMain.h"
 #include "AL/al.h"
 #include "AL/alc.h"
@@ -34,6 +41,20 @@
 
 #define LookupDatabuffer(m, k) ((ALdatabuffer*)LookupUIntMapKey(&(m), (k)))
 
+static ALvoid FreeDatabufferData(ALdatabuffer *ALBuf)
+{
+#ifdef HAVE_MMAP
+    if(ALBuf->MapBase)
+        munmap(ALBuf->MapBase, ALBuf->MapSize);
+    else
+#endif
+        free(ALBuf->data);
+    ALBuf->MapBase = NULL;
+    ALBuf->MapSize = 0;
+    ALBuf->data = NULL;
+    ALBuf->size = 0;
+}
+
 /*
 *    alGenDatabuffersEXT(ALsizei n, ALuint *puiBuffers)
 *
@@ -127,7 +148,7 @@ AL_API ALvoid AL_APIENTRY alDeleteDatabuffersEXT(ALsizei n, const ALuint *buffer
                 Failed = AL_TRUE;
                 break;
             }
-            else if(ALBuf->state != UNMAPPED)
+            else if(ALBuf->state != UNMAPPED || ALBuf->refcount != 0)
             {
                 /* Databuffer still in use, cannot be deleted */
                 alSetError(Context, AL_INVALID_OPERATION);
@@ -151,7 +172,7 @@ AL_API ALvoid AL_APIENTRY alDeleteDatabuffersEXT(ALsizei n, const ALuint *buffer
                 Context->SampleSink = NULL;
 
             // Release the memory used to store audio data
-            free(ALBuf->data);
+            FreeDatabufferData(ALBuf);
 
             // Release buffer structure
             RemoveUIntMapKey(&device->DatabufferMap, ALBuf->databuffer);
@@ -206,7 +227,7 @@ AL_API ALvoid AL_APIENTRY alDatabufferDataEXT(ALuint buffer,const ALvoid *data,A
     Device = Context->Device;
     if((ALBuf=LookupDatabuffer(Device->DatabufferMap, buffer)) != NULL)
     {
-        if(ALBuf->state == UNMAPPED)
+        if(ALBuf->state == UNMAPPED && ALBuf->refcount == 0)
         {
             if(usage == AL_STREAM_WRITE_EXT || usage == AL_STREAM_READ_EXT ||
                usage == AL_STREAM_COPY_EXT || usage == AL_STATIC_WRITE_EXT ||
@@ -216,6 +237,10 @@ AL_API ALvoid AL_APIENTRY alDatabufferDataEXT(ALuint buffer,const ALvoid *data,A
             {
                 if(size >= 0)
                 {
+                    /* A file view can't be resized in place */
+                    if(ALBuf->MapBase)
+                        FreeDatabufferData(ALBuf);
+
                     /* (Re)allocate data */
                     temp = realloc(ALBuf->data, size);
                     if(temp)
@@ -244,6 +269,111 @@ AL_API ALvoid AL_APIENTRY alDatabufferDataEXT(ALuint buffer,const ALvoid *data,A
     ProcessContext(Context);
 }
 
+/*
+*    alDatabufferFileSOFT(ALuint buffer, const ALchar *filename,
+*                         ALintptrEXT start, ALsizeiptrEXT length)
+*
+*    Fill databuffer with a range of a file. Where supported the range is
+*    memory-mapped rather than read, so the data is paged in on demand and
+*    shared with anything else mapping the same file. A length of 0 takes
+*    the rest of the file. The range can't be empty, so a start at or past
+*    the end of the file is an invalid value.
+*/
+AL_API ALvoid AL_APIENTRY alDatabufferFileSOFT(ALuint buffer, const ALchar *filename, ALintptrEXT start, ALsizeiptrEXT length)
+{
+    ALCcontext *Context;
+    ALdatabuffer *ALBuf;
+    ALCdevice *Device;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    Device = Context->Device;
+    if((ALBuf=LookupDatabuffer(Device->DatabufferMap, buffer)) == NULL)
+        alSetError(Context, AL_INVALID_NAME);
+    else if(ALBuf->state != UNMAPPED || ALBuf->refcount != 0)
+        alSetError(Context, AL_INVALID_OPERATION);
+    else if(!filename || start < 0 || length < 0)
+        alSetError(Context, AL_INVALID_VALUE);
+    else
+    {
+#ifdef HAVE_MMAP
+        struct stat st;
+        ALintptrEXT pagestart;
+        ALvoid *base;
+        int fd;
+
+        fd = open(filename, O_RDONLY);
+        if(fd < 0 || fstat(fd, &st) != 0 || start >= st.st_size ||
+           length > st.st_size-start)
+        {
+            alSetError(Context, AL_INVALID_VALUE);
+            if(fd >= 0) close(fd);
+            ProcessContext(Context);
+            return;
+        }
+        if(length == 0)
+            length = st.st_size - start;
+
+        /* mmap offsets must be page aligned, so map from the start of the
+         * page and offset the data pointer into it. The private mapping lets
+         * the app write to the data without touching the file. */
+        pagestart = start - (start%sysconf(_SC_PAGESIZE));
+        base = mmap(NULL, length + (start-pagestart), PROT_READ|PROT_WRITE,
+                    MAP_PRIVATE, fd, pagestart);
+        close(fd);
+
+        if(base == MAP_FAILED)
+            alSetError(Context, AL_OUT_OF_MEMORY);
+        else
+        {
+            FreeDatabufferData(ALBuf);
+            ALBuf->MapBase = base;
+            ALBuf->MapSize = length + (start-pagestart);
+            ALBuf->data = (ALubyte*)base + (start-pagestart);
+            ALBuf->size = length;
+            ALBuf->usage = AL_STATIC_READ_EXT;
+        }
+#else
+        ALubyte *temp = NULL;
+        long filesize;
+        FILE *f;
+
+        f = fopen(filename, "rb");
+        if(!f || fseek(f, 0, SEEK_END) != 0 || (filesize=ftell(f)) < 0 ||
+           start >= filesize || length > filesize-start)
+        {
+            alSetError(Context, AL_INVALID_VALUE);
+            if(f) fclose(f);
+            ProcessContext(Context);
+            return;
+        }
+        if(length == 0)
+            length = filesize - start;
+
+        if(fseek(f, start, SEEK_SET) != 0)
+            alSetError(Context, AL_INVALID_VALUE);
+        else if((temp=malloc(length)) == NULL)
+            alSetError(Context, AL_OUT_OF_MEMORY);
+        else if(fread(temp, 1, length, f) != (size_t)length)
+        {
+            alSetError(Context, AL_INVALID_VALUE);
+            free(temp);
+        }
+        else
+        {
+            FreeDatabufferData(ALBuf);
+            ALBuf->data = temp;
+            ALBuf->size = length;
+            ALBuf->usage = AL_STATIC_READ_EXT;
+        }
+        fclose(f);
+#endif
+    }
+
+    ProcessContext(Context);
+}
+
 AL_API ALvoid AL_APIENTRY alDatabufferSubDataEXT(ALuint uiBuffer, ALintptrEXT start, ALsizeiptrEXT length, const ALvoid *data)
 {
     ALCcontext    *pContext;
@@ -638,7 +768,7 @@ ALvoid ReleaseALDatabuffers(ALCdevice *device)
         device->DatabufferMap.array[i].value = NULL;
 
         // Release buffer data
-        free(temp->data);
+        FreeDatabufferData(temp);
 
         // Release Buffer structure
         ALTHUNK_REMOVEENTRY(temp->databuffer);
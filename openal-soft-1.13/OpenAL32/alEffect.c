@@ -171,7 +171,11 @@ AL_API ALvoid AL_APIENTRY alEffecti(ALuint effect, ALenum param, ALint iValue)
                 (iValue == AL_EFFECT_EAXREVERB && !DisabledEffects[EAXREVERB]) ||
                 (iValue == AL_EFFECT_REVERB && !DisabledEffects[REVERB]) ||
                 (iValue == AL_EFFECT_ECHO && !DisabledEffects[ECHO]) ||
-                (iValue == AL_EFFECT_RING_MODULATOR && !DisabledEffects[MODULATOR]));
+                (iValue == AL_EFFECT_RING_MODULATOR && !DisabledEffects[MODULATOR]) ||
+                (iValue == AL_EFFECT_EQUALIZER && !DisabledEffects[EQUALIZER]) ||
+                (iValue == AL_EFFECT_COMPRESSOR && !DisabledEffects[COMPRESSOR]) ||
+                (iValue == AL_EFFECT_CHORUS && !DisabledEffects[CHORUS]) ||
+                (iValue == AL_EFFECT_FLANGER && !DisabledEffects[FLANGER]));
 
             if(isOk)
                 InitEffectParams(ALEffect, iValue);
@@ -243,6 +247,96 @@ AL_API ALvoid AL_APIENTRY alEffecti(ALuint effect, ALenum param, ALint iValue)
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            case AL_COMPRESSOR_ONOFF:
+                if(iValue >= AL_COMPRESSOR_MIN_ONOFF &&
+                   iValue <= AL_COMPRESSOR_MAX_ONOFF)
+                    ALEffect->Compressor.OnOff = iValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_WAVEFORM:
+                if(iValue >= AL_CHORUS_MIN_WAVEFORM &&
+                   iValue <= AL_CHORUS_MAX_WAVEFORM)
+                    ALEffect->Chorus.Waveform = iValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_CHORUS_PHASE:
+                if(iValue >= AL_CHORUS_MIN_PHASE &&
+                   iValue <= AL_CHORUS_MAX_PHASE)
+                    ALEffect->Chorus.Phase = iValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_CHORUS_RATE:
+            case AL_CHORUS_DEPTH:
+            case AL_CHORUS_FEEDBACK:
+            case AL_CHORUS_DELAY:
+                alEffectf(effect, param, (ALfloat)iValue);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_WAVEFORM:
+                if(iValue >= AL_FLANGER_MIN_WAVEFORM &&
+                   iValue <= AL_FLANGER_MAX_WAVEFORM)
+                    ALEffect->Chorus.Waveform = iValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_FLANGER_PHASE:
+                if(iValue >= AL_FLANGER_MIN_PHASE &&
+                   iValue <= AL_FLANGER_MAX_PHASE)
+                    ALEffect->Chorus.Phase = iValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_FLANGER_RATE:
+            case AL_FLANGER_DEPTH:
+            case AL_FLANGER_FEEDBACK:
+            case AL_FLANGER_DELAY:
+                alEffectf(effect, param, (ALfloat)iValue);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -318,6 +412,64 @@ AL_API ALvoid AL_APIENTRY alEffectiv(ALuint effect, ALenum param, ALint *piValue
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            case AL_COMPRESSOR_ONOFF:
+                alEffecti(effect, param, piValues[0]);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_WAVEFORM:
+            case AL_CHORUS_PHASE:
+            case AL_CHORUS_RATE:
+            case AL_CHORUS_DEPTH:
+            case AL_CHORUS_FEEDBACK:
+            case AL_CHORUS_DELAY:
+                alEffecti(effect, param, piValues[0]);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_WAVEFORM:
+            case AL_FLANGER_PHASE:
+            case AL_FLANGER_RATE:
+            case AL_FLANGER_DEPTH:
+            case AL_FLANGER_FEEDBACK:
+            case AL_FLANGER_DELAY:
+                alEffecti(effect, param, piValues[0]);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -681,6 +833,186 @@ AL_API ALvoid AL_APIENTRY alEffectf(ALuint effect, ALenum param, ALfloat flValue
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            case AL_EQUALIZER_LOW_GAIN:
+                if(flValue >= AL_EQUALIZER_MIN_LOW_GAIN &&
+                   flValue <= AL_EQUALIZER_MAX_LOW_GAIN)
+                    ALEffect->Equalizer.LowGain = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_LOW_CUTOFF:
+                if(flValue >= AL_EQUALIZER_MIN_LOW_CUTOFF &&
+                   flValue <= AL_EQUALIZER_MAX_LOW_CUTOFF)
+                    ALEffect->Equalizer.LowCutoff = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_MID1_GAIN:
+                if(flValue >= AL_EQUALIZER_MIN_MID1_GAIN &&
+                   flValue <= AL_EQUALIZER_MAX_MID1_GAIN)
+                    ALEffect->Equalizer.Mid1Gain = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_MID1_CENTER:
+                if(flValue >= AL_EQUALIZER_MIN_MID1_CENTER &&
+                   flValue <= AL_EQUALIZER_MAX_MID1_CENTER)
+                    ALEffect->Equalizer.Mid1Center = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_MID1_WIDTH:
+                if(flValue >= AL_EQUALIZER_MIN_MID1_WIDTH &&
+                   flValue <= AL_EQUALIZER_MAX_MID1_WIDTH)
+                    ALEffect->Equalizer.Mid1Width = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_MID2_GAIN:
+                if(flValue >= AL_EQUALIZER_MIN_MID2_GAIN &&
+                   flValue <= AL_EQUALIZER_MAX_MID2_GAIN)
+                    ALEffect->Equalizer.Mid2Gain = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_MID2_CENTER:
+                if(flValue >= AL_EQUALIZER_MIN_MID2_CENTER &&
+                   flValue <= AL_EQUALIZER_MAX_MID2_CENTER)
+                    ALEffect->Equalizer.Mid2Center = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_MID2_WIDTH:
+                if(flValue >= AL_EQUALIZER_MIN_MID2_WIDTH &&
+                   flValue <= AL_EQUALIZER_MAX_MID2_WIDTH)
+                    ALEffect->Equalizer.Mid2Width = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_HIGH_GAIN:
+                if(flValue >= AL_EQUALIZER_MIN_HIGH_GAIN &&
+                   flValue <= AL_EQUALIZER_MAX_HIGH_GAIN)
+                    ALEffect->Equalizer.HighGain = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_EQUALIZER_HIGH_CUTOFF:
+                if(flValue >= AL_EQUALIZER_MIN_HIGH_CUTOFF &&
+                   flValue <= AL_EQUALIZER_MAX_HIGH_CUTOFF)
+                    ALEffect->Equalizer.HighCutoff = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_RATE:
+                if(flValue >= AL_CHORUS_MIN_RATE &&
+                   flValue <= AL_CHORUS_MAX_RATE)
+                    ALEffect->Chorus.Rate = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_CHORUS_DEPTH:
+                if(flValue >= AL_CHORUS_MIN_DEPTH &&
+                   flValue <= AL_CHORUS_MAX_DEPTH)
+                    ALEffect->Chorus.Depth = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_CHORUS_FEEDBACK:
+                if(flValue >= AL_CHORUS_MIN_FEEDBACK &&
+                   flValue <= AL_CHORUS_MAX_FEEDBACK)
+                    ALEffect->Chorus.Feedback = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_CHORUS_DELAY:
+                if(flValue >= AL_CHORUS_MIN_DELAY &&
+                   flValue <= AL_CHORUS_MAX_DELAY)
+                    ALEffect->Chorus.Delay = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_RATE:
+                if(flValue >= AL_FLANGER_MIN_RATE &&
+                   flValue <= AL_FLANGER_MAX_RATE)
+                    ALEffect->Chorus.Rate = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_FLANGER_DEPTH:
+                if(flValue >= AL_FLANGER_MIN_DEPTH &&
+                   flValue <= AL_FLANGER_MAX_DEPTH)
+                    ALEffect->Chorus.Depth = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_FLANGER_FEEDBACK:
+                if(flValue >= AL_FLANGER_MIN_FEEDBACK &&
+                   flValue <= AL_FLANGER_MAX_FEEDBACK)
+                    ALEffect->Chorus.Feedback = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_FLANGER_DELAY:
+                if(flValue >= AL_FLANGER_MIN_DELAY &&
+                   flValue <= AL_FLANGER_MAX_DELAY)
+                    ALEffect->Chorus.Delay = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -810,6 +1142,69 @@ AL_API ALvoid AL_APIENTRY alEffectfv(ALuint effect, ALenum param, ALfloat *pflVa
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            case AL_EQUALIZER_LOW_GAIN:
+            case AL_EQUALIZER_LOW_CUTOFF:
+            case AL_EQUALIZER_MID1_GAIN:
+            case AL_EQUALIZER_MID1_CENTER:
+            case AL_EQUALIZER_MID1_WIDTH:
+            case AL_EQUALIZER_MID2_GAIN:
+            case AL_EQUALIZER_MID2_CENTER:
+            case AL_EQUALIZER_MID2_WIDTH:
+            case AL_EQUALIZER_HIGH_GAIN:
+            case AL_EQUALIZER_HIGH_CUTOFF:
+                alEffectf(effect, param, pflValues[0]);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_RATE:
+            case AL_CHORUS_DEPTH:
+            case AL_CHORUS_FEEDBACK:
+            case AL_CHORUS_DELAY:
+                alEffectf(effect, param, pflValues[0]);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_RATE:
+            case AL_FLANGER_DEPTH:
+            case AL_FLANGER_FEEDBACK:
+            case AL_FLANGER_DELAY:
+                alEffectf(effect, param, pflValues[0]);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -889,6 +1284,84 @@ AL_API ALvoid AL_APIENTRY alGetEffecti(ALuint effect, ALenum param, ALint *piVal
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            case AL_COMPRESSOR_ONOFF:
+                *piValue = ALEffect->Compressor.OnOff;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_WAVEFORM:
+                *piValue = ALEffect->Chorus.Waveform;
+                break;
+            case AL_CHORUS_PHASE:
+                *piValue = ALEffect->Chorus.Phase;
+                break;
+            case AL_CHORUS_RATE:
+                *piValue = (ALint)ALEffect->Chorus.Rate;
+                break;
+            case AL_CHORUS_DEPTH:
+                *piValue = (ALint)ALEffect->Chorus.Depth;
+                break;
+            case AL_CHORUS_FEEDBACK:
+                *piValue = (ALint)ALEffect->Chorus.Feedback;
+                break;
+            case AL_CHORUS_DELAY:
+                *piValue = (ALint)ALEffect->Chorus.Delay;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_WAVEFORM:
+                *piValue = ALEffect->Chorus.Waveform;
+                break;
+            case AL_FLANGER_PHASE:
+                *piValue = ALEffect->Chorus.Phase;
+                break;
+            case AL_FLANGER_RATE:
+                *piValue = (ALint)ALEffect->Chorus.Rate;
+                break;
+            case AL_FLANGER_DEPTH:
+                *piValue = (ALint)ALEffect->Chorus.Depth;
+                break;
+            case AL_FLANGER_FEEDBACK:
+                *piValue = (ALint)ALEffect->Chorus.Feedback;
+                break;
+            case AL_FLANGER_DELAY:
+                *piValue = (ALint)ALEffect->Chorus.Delay;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -964,6 +1437,64 @@ AL_API ALvoid AL_APIENTRY alGetEffectiv(ALuint effect, ALenum param, ALint *piVa
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            case AL_COMPRESSOR_ONOFF:
+                alGetEffecti(effect, param, piValues);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_WAVEFORM:
+            case AL_CHORUS_PHASE:
+            case AL_CHORUS_RATE:
+            case AL_CHORUS_DEPTH:
+            case AL_CHORUS_FEEDBACK:
+            case AL_CHORUS_DELAY:
+                alGetEffecti(effect, param, piValues);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_WAVEFORM:
+            case AL_FLANGER_PHASE:
+            case AL_FLANGER_RATE:
+            case AL_FLANGER_DEPTH:
+            case AL_FLANGER_FEEDBACK:
+            case AL_FLANGER_DELAY:
+                alGetEffecti(effect, param, piValues);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -1176,6 +1707,108 @@ AL_API ALvoid AL_APIENTRY alGetEffectf(ALuint effect, ALenum param, ALfloat *pfl
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            case AL_EQUALIZER_LOW_GAIN:
+                *pflValue = ALEffect->Equalizer.LowGain;
+                break;
+
+            case AL_EQUALIZER_LOW_CUTOFF:
+                *pflValue = ALEffect->Equalizer.LowCutoff;
+                break;
+
+            case AL_EQUALIZER_MID1_GAIN:
+                *pflValue = ALEffect->Equalizer.Mid1Gain;
+                break;
+
+            case AL_EQUALIZER_MID1_CENTER:
+                *pflValue = ALEffect->Equalizer.Mid1Center;
+                break;
+
+            case AL_EQUALIZER_MID1_WIDTH:
+                *pflValue = ALEffect->Equalizer.Mid1Width;
+                break;
+
+            case AL_EQUALIZER_MID2_GAIN:
+                *pflValue = ALEffect->Equalizer.Mid2Gain;
+                break;
+
+            case AL_EQUALIZER_MID2_CENTER:
+                *pflValue = ALEffect->Equalizer.Mid2Center;
+                break;
+
+            case AL_EQUALIZER_MID2_WIDTH:
+                *pflValue = ALEffect->Equalizer.Mid2Width;
+                break;
+
+            case AL_EQUALIZER_HIGH_GAIN:
+                *pflValue = ALEffect->Equalizer.HighGain;
+                break;
+
+            case AL_EQUALIZER_HIGH_CUTOFF:
+                *pflValue = ALEffect->Equalizer.HighCutoff;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_RATE:
+                *pflValue = ALEffect->Chorus.Rate;
+                break;
+            case AL_CHORUS_DEPTH:
+                *pflValue = ALEffect->Chorus.Depth;
+                break;
+            case AL_CHORUS_FEEDBACK:
+                *pflValue = ALEffect->Chorus.Feedback;
+                break;
+            case AL_CHORUS_DELAY:
+                *pflValue = ALEffect->Chorus.Delay;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_RATE:
+                *pflValue = ALEffect->Chorus.Rate;
+                break;
+            case AL_FLANGER_DEPTH:
+                *pflValue = ALEffect->Chorus.Depth;
+                break;
+            case AL_FLANGER_FEEDBACK:
+                *pflValue = ALEffect->Chorus.Feedback;
+                break;
+            case AL_FLANGER_DELAY:
+                *pflValue = ALEffect->Chorus.Delay;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -1295,6 +1928,69 @@ AL_API ALvoid AL_APIENTRY alGetEffectfv(ALuint effect, ALenum param, ALfloat *pf
                 break;
             }
         }
+        else if(ALEffect->type == AL_EFFECT_EQUALIZER)
+        {
+            switch(param)
+            {
+            case AL_EQUALIZER_LOW_GAIN:
+            case AL_EQUALIZER_LOW_CUTOFF:
+            case AL_EQUALIZER_MID1_GAIN:
+            case AL_EQUALIZER_MID1_CENTER:
+            case AL_EQUALIZER_MID1_WIDTH:
+            case AL_EQUALIZER_MID2_GAIN:
+            case AL_EQUALIZER_MID2_CENTER:
+            case AL_EQUALIZER_MID2_WIDTH:
+            case AL_EQUALIZER_HIGH_GAIN:
+            case AL_EQUALIZER_HIGH_CUTOFF:
+                alGetEffectf(effect, param, pflValues);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_COMPRESSOR)
+        {
+            switch(param)
+            {
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_CHORUS)
+        {
+            switch(param)
+            {
+            case AL_CHORUS_RATE:
+            case AL_CHORUS_DEPTH:
+            case AL_CHORUS_FEEDBACK:
+            case AL_CHORUS_DELAY:
+                alGetEffectf(effect, param, pflValues);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
+        else if(ALEffect->type == AL_EFFECT_FLANGER)
+        {
+            switch(param)
+            {
+            case AL_FLANGER_RATE:
+            case AL_FLANGER_DEPTH:
+            case AL_FLANGER_FEEDBACK:
+            case AL_FLANGER_DELAY:
+                alGetEffectf(effect, param, pflValues);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+        }
         else
             alSetError(Context, AL_INVALID_ENUM);
     }
@@ -1372,5 +2068,36 @@ static void InitEffectParams(ALeffect *effect, ALenum type)
         effect->Modulator.HighPassCutoff = AL_RING_MODULATOR_DEFAULT_HIGHPASS_CUTOFF;
         effect->Modulator.Waveform = AL_RING_MODULATOR_DEFAULT_WAVEFORM;
         break;
+    case AL_EFFECT_EQUALIZER:
+        effect->Equalizer.LowGain = AL_EQUALIZER_DEFAULT_LOW_GAIN;
+        effect->Equalizer.LowCutoff = AL_EQUALIZER_DEFAULT_LOW_CUTOFF;
+        effect->Equalizer.Mid1Gain = AL_EQUALIZER_DEFAULT_MID1_GAIN;
+        effect->Equalizer.Mid1Center = AL_EQUALIZER_DEFAULT_MID1_CENTER;
+        effect->Equalizer.Mid1Width = AL_EQUALIZER_DEFAULT_MID1_WIDTH;
+        effect->Equalizer.Mid2Gain = AL_EQUALIZER_DEFAULT_MID2_GAIN;
+        effect->Equalizer.Mid2Center = AL_EQUALIZER_DEFAULT_MID2_CENTER;
+        effect->Equalizer.Mid2Width = AL_EQUALIZER_DEFAULT_MID2_WIDTH;
+        effect->Equalizer.HighGain = AL_EQUALIZER_DEFAULT_HIGH_GAIN;
+        effect->Equalizer.HighCutoff = AL_EQUALIZER_DEFAULT_HIGH_CUTOFF;
+        break;
+    case AL_EFFECT_COMPRESSOR:
+        effect->Compressor.OnOff = AL_COMPRESSOR_DEFAULT_ONOFF;
+        break;
+    case AL_EFFECT_CHORUS:
+        effect->Chorus.Waveform = AL_CHORUS_DEFAULT_WAVEFORM;
+        effect->Chorus.Phase = AL_CHORUS_DEFAULT_PHASE;
+        effect->Chorus.Rate = AL_CHORUS_DEFAULT_RATE;
+        effect->Chorus.Depth = AL_CHORUS_DEFAULT_DEPTH;
+        effect->Chorus.Feedback = AL_CHORUS_DEFAULT_FEEDBACK;
+        effect->Chorus.Delay = AL_CHORUS_DEFAULT_DELAY;
+        break;
+    case AL_EFFECT_FLANGER:
+        effect->Chorus.Waveform = AL_FLANGER_DEFAULT_WAVEFORM;
+        effect->Chorus.Phase = AL_FLANGER_DEFAULT_PHASE;
+        effect->Chorus.Rate = AL_FLANGER_DEFAULT_RATE;
+        effect->Chorus.Depth = AL_FLANGER_DEFAULT_DEPTH;
+        effect->Chorus.Feedback = AL_FLANGER_DEFAULT_FEEDBACK;
+        effect->Chorus.Delay = AL_FLANGER_DEFAULT_DELAY;
+        break;
     }
 }
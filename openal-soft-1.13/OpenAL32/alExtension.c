@@ -180,27 +180,30 @@ static const ALenums enumeration[] = {
     { "AL_FILTER_TYPE",                       AL_FILTER_TYPE                      },
     { "AL_FILTER_NULL",                       AL_FILTER_NULL                      },
     { "AL_FILTER_LOWPASS",                    AL_FILTER_LOWPASS                   },
-#if 0
     { "AL_FILTER_HIGHPASS",                   AL_FILTER_HIGHPASS                  },
     { "AL_FILTER_BANDPASS",                   AL_FILTER_BANDPASS                  },
-#endif
 
     // Filter params
     { "AL_LOWPASS_GAIN",                      AL_LOWPASS_GAIN                     },
     { "AL_LOWPASS_GAINHF",                    AL_LOWPASS_GAINHF                   },
+    { "AL_HIGHPASS_GAIN",                     AL_HIGHPASS_GAIN                    },
+    { "AL_HIGHPASS_GAINLF",                   AL_HIGHPASS_GAINLF                  },
+    { "AL_BANDPASS_GAIN",                     AL_BANDPASS_GAIN                    },
+    { "AL_BANDPASS_GAINLF",                   AL_BANDPASS_GAINLF                  },
+    { "AL_BANDPASS_GAINHF",                   AL_BANDPASS_GAINHF                  },
 
     // Effect types
     { "AL_EFFECT_TYPE",                       AL_EFFECT_TYPE                      },
     { "AL_EFFECT_NULL",                       AL_EFFECT_NULL                      },
     { "AL_EFFECT_REVERB",                     AL_EFFECT_REVERB                    },
     { "AL_EFFECT_EAXREVERB",                  AL_EFFECT_EAXREVERB                 },
-#if 0
     { "AL_EFFECT_CHORUS",                     AL_EFFECT_CHORUS                    },
+#if 0
     { "AL_EFFECT_DISTORTION",                 AL_EFFECT_DISTORTION                },
 #endif
     { "AL_EFFECT_ECHO",                       AL_EFFECT_ECHO                      },
-#if 0
     { "AL_EFFECT_FLANGER",                    AL_EFFECT_FLANGER                   },
+#if 0
     { "AL_EFFECT_FREQUENCY_SHIFTER",          AL_EFFECT_FREQUENCY_SHIFTER         },
     { "AL_EFFECT_VOCAL_MORPHER",              AL_EFFECT_VOCAL_MORPHER             },
     { "AL_EFFECT_PITCH_SHIFTER",              AL_EFFECT_PITCH_SHIFTER             },
@@ -208,9 +211,9 @@ static const ALenums enumeration[] = {
     { "AL_EFFECT_RING_MODULATOR",             AL_EFFECT_RING_MODULATOR            },
 #if 0
     { "AL_EFFECT_AUTOWAH",                    AL_EFFECT_AUTOWAH                   },
+#endif
     { "AL_EFFECT_COMPRESSOR",                 AL_EFFECT_COMPRESSOR                },
     { "AL_EFFECT_EQUALIZER",                  AL_EFFECT_EQUALIZER                 },
-#endif
 
     // Reverb params
     { "AL_REVERB_DENSITY",                    AL_REVERB_DENSITY                   },
@@ -264,6 +267,37 @@ static const ALenums enumeration[] = {
     { "AL_RING_MODULATOR_HIGHPASS_CUTOFF",    AL_RING_MODULATOR_HIGHPASS_CUTOFF   },
     { "AL_RING_MODULATOR_WAVEFORM",           AL_RING_MODULATOR_WAVEFORM          },
 
+    // Chorus params
+    { "AL_CHORUS_WAVEFORM",                   AL_CHORUS_WAVEFORM                  },
+    { "AL_CHORUS_PHASE",                      AL_CHORUS_PHASE                     },
+    { "AL_CHORUS_RATE",                       AL_CHORUS_RATE                      },
+    { "AL_CHORUS_DEPTH",                      AL_CHORUS_DEPTH                     },
+    { "AL_CHORUS_FEEDBACK",                   AL_CHORUS_FEEDBACK                  },
+    { "AL_CHORUS_DELAY",                      AL_CHORUS_DELAY                     },
+
+    // Flanger params
+    { "AL_FLANGER_WAVEFORM",                  AL_FLANGER_WAVEFORM                 },
+    { "AL_FLANGER_PHASE",                     AL_FLANGER_PHASE                    },
+    { "AL_FLANGER_RATE",                      AL_FLANGER_RATE                     },
+    { "AL_FLANGER_DEPTH",                     AL_FLANGER_DEPTH                    },
+    { "AL_FLANGER_FEEDBACK",                  AL_FLANGER_FEEDBACK                 },
+    { "AL_FLANGER_DELAY",                     AL_FLANGER_DELAY                    },
+
+    // Compressor params
+    { "AL_COMPRESSOR_ONOFF",                  AL_COMPRESSOR_ONOFF                 },
+
+    // Equalizer params
+    { "AL_EQUALIZER_LOW_GAIN",                AL_EQUALIZER_LOW_GAIN               },
+    { "AL_EQUALIZER_LOW_CUTOFF",              AL_EQUALIZER_LOW_CUTOFF             },
+    { "AL_EQUALIZER_MID1_GAIN",               AL_EQUALIZER_MID1_GAIN              },
+    { "AL_EQUALIZER_MID1_CENTER",             AL_EQUALIZER_MID1_CENTER            },
+    { "AL_EQUALIZER_MID1_WIDTH",              AL_EQUALIZER_MID1_WIDTH             },
+    { "AL_EQUALIZER_MID2_GAIN",               AL_EQUALIZER_MID2_GAIN              },
+    { "AL_EQUALIZER_MID2_CENTER",             AL_EQUALIZER_MID2_CENTER            },
+    { "AL_EQUALIZER_MID2_WIDTH",              AL_EQUALIZER_MID2_WIDTH             },
+    { "AL_EQUALIZER_HIGH_GAIN",               AL_EQUALIZER_HIGH_GAIN              },
+    { "AL_EQUALIZER_HIGH_CUTOFF",             AL_EQUALIZER_HIGH_CUTOFF            },
+
 
     // Default
     { NULL,                                   (ALenum)0                           }
@@ -165,7 +165,9 @@ AL_API ALvoid AL_APIENTRY alFilteri(ALuint filter, ALenum param, ALint iValue)
         {
         case AL_FILTER_TYPE:
             if(iValue == AL_FILTER_NULL ||
-               iValue == AL_FILTER_LOWPASS)
+               iValue == AL_FILTER_LOWPASS ||
+               iValue == AL_FILTER_HIGHPASS ||
+               iValue == AL_FILTER_BANDPASS)
                 InitFilterParams(ALFilter, iValue);
             else
                 alSetError(Context, AL_INVALID_VALUE);
@@ -247,6 +249,59 @@ AL_API ALvoid AL_APIENTRY alFilterf(ALuint filter, ALenum param, ALfloat flValue
             }
             break;
 
+        case AL_FILTER_HIGHPASS:
+            switch(param)
+            {
+            case AL_HIGHPASS_GAIN:
+                if(flValue >= HIGHPASS_MIN_GAIN && flValue <= HIGHPASS_MAX_GAIN)
+                    ALFilter->Gain = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_HIGHPASS_GAINLF:
+                if(flValue >= HIGHPASS_MIN_GAINLF && flValue <= HIGHPASS_MAX_GAINLF)
+                    ALFilter->GainLF = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+            break;
+
+        case AL_FILTER_BANDPASS:
+            switch(param)
+            {
+            case AL_BANDPASS_GAIN:
+                if(flValue >= BANDPASS_MIN_GAIN && flValue <= BANDPASS_MAX_GAIN)
+                    ALFilter->Gain = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_BANDPASS_GAINLF:
+                if(flValue >= BANDPASS_MIN_GAINLF && flValue <= BANDPASS_MAX_GAINLF)
+                    ALFilter->GainLF = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            case AL_BANDPASS_GAINHF:
+                if(flValue >= BANDPASS_MIN_GAINHF && flValue <= BANDPASS_MAX_GAINHF)
+                    ALFilter->GainHF = flValue;
+                else
+                    alSetError(Context, AL_INVALID_VALUE);
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+            break;
+
         default:
             alSetError(Context, AL_INVALID_ENUM);
             break;
@@ -370,6 +425,44 @@ AL_API ALvoid AL_APIENTRY alGetFilterf(ALuint filter, ALenum param, ALfloat *pfl
             }
             break;
 
+        case AL_FILTER_HIGHPASS:
+            switch(param)
+            {
+            case AL_HIGHPASS_GAIN:
+                *pflValue = ALFilter->Gain;
+                break;
+
+            case AL_HIGHPASS_GAINLF:
+                *pflValue = ALFilter->GainLF;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+            break;
+
+        case AL_FILTER_BANDPASS:
+            switch(param)
+            {
+            case AL_BANDPASS_GAIN:
+                *pflValue = ALFilter->Gain;
+                break;
+
+            case AL_BANDPASS_GAINLF:
+                *pflValue = ALFilter->GainLF;
+                break;
+
+            case AL_BANDPASS_GAINHF:
+                *pflValue = ALFilter->GainHF;
+                break;
+
+            default:
+                alSetError(Context, AL_INVALID_ENUM);
+                break;
+            }
+            break;
+
         default:
             alSetError(Context, AL_INVALID_ENUM);
             break;
@@ -428,4 +521,5 @@ static void InitFilterParams(ALfilter *filter, ALenum type)
 
     filter->Gain = 1.0;
     filter->GainHF = 1.0;
+    filter->GainLF = 1.0;
 }
@@ -536,7 +536,11 @@ AL_API ALvoid AL_APIENTRY alSourcei(ALuint source,ALenum eParam,ALint lValue)
                 {
                     ALbuffer *buffer = NULL;
 
-                    if(lValue == 0 ||
+                    if(lValue != 0 &&
+                       (buffer=LookupBuffer(device->BufferMap, lValue)) != NULL &&
+                       buffer->Pending)
+                        alSetError(pContext, AL_INVALID_OPERATION);
+                    else if(lValue == 0 ||
                        (buffer=LookupBuffer(device->BufferMap, lValue)) != NULL)
                     {
                         // Remove all elements in the queue
@@ -1597,6 +1601,12 @@ AL_API ALvoid AL_APIENTRY alSourceQueueBuffers(ALuint source, ALsizei n, const A
             alSetError(Context, AL_INVALID_NAME);
             goto done;
         }
+        if(buffer->Pending)
+        {
+            /* Still being converted by an async upload */
+            alSetError(Context, AL_INVALID_OPERATION);
+            goto done;
+        }
 
         if(BufferFmt == NULL)
         {
@@ -0,0 +1,519 @@
+/*
+ * OpenAL Benchmark Utility
+ *
+ * Copyright (c) 2010 by authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Times parts of the library through the public API. Everything runs on a
+ * loopback device, so there's no mixer thread competing with the
+ * measurements, and the library's settings (e.g. buffer-storage) come from
+ * the usual config files. Times are the best of several runs, in CPU time.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "AL/alc.h"
+#include "AL/al.h"
+#include "AL/alext.h"
+#include "AL/efx.h"
+
+#ifndef ALC_SOFT_loopback
+#define ALC_FORMAT_CHANNELS_SOFT                 0x1990
+#define ALC_FORMAT_TYPE_SOFT                     0x1991
+#define ALC_FLOAT_SOFT                           0x1406
+#define ALC_STEREO_SOFT                          0x1501
+typedef ALCdevice* (ALC_APIENTRY*LPALCLOOPBACKOPENDEVICESOFT)(const ALCchar*);
+typedef void (ALC_APIENTRY*LPALCRENDERSAMPLESSOFT)(ALCdevice*, ALCvoid*, ALCsizei);
+#endif
+#ifndef AL_FORMAT_MONO_MULAW
+#define AL_FORMAT_MONO_MULAW                     0x10014
+#endif
+static LPALCLOOPBACKOPENDEVICESOFT palcLoopbackOpenDeviceSOFT;
+static LPALCRENDERSAMPLESSOFT      palcRenderSamplesSOFT;
+
+static LPALGENEFFECTS                palGenEffects;
+static LPALDELETEEFFECTS             palDeleteEffects;
+static LPALEFFECTI                   palEffecti;
+static LPALEFFECTF                   palEffectf;
+static LPALGENAUXILIARYEFFECTSLOTS    palGenAuxiliaryEffectSlots;
+static LPALDELETEAUXILIARYEFFECTSLOTS palDeleteAuxiliaryEffectSlots;
+static LPALAUXILIARYEFFECTSLOTI       palAuxiliaryEffectSloti;
+
+
+#define FREQUENCY    44100
+#define NUM_RUNS     10
+#define RENDER_SIZE  1024
+
+
+static double getSeconds(clock_t start)
+{
+    return (double)(clock()-start) / CLOCKS_PER_SEC;
+}
+
+/* Deterministic white noise, so runs are comparable */
+static unsigned int noiseSeed = 22222;
+static float noise(void)
+{
+    noiseSeed = noiseSeed*1103515245 + 12345;
+    return (float)((noiseSeed>>8)&0xffff)/32768.0f - 1.0f;
+}
+
+
+/* Conversion throughput for each source type that can be loaded, into
+ * whatever storage the library picks for it. The storage type is read back
+ * from the buffer, so running with buffer-storage=short shows the float and
+ * double to short pairs. */
+#define CONV_SAMPLES (1<<20)
+
+static const struct {
+    const char *name;
+    ALenum format;
+    ALsizei size;
+} convFormats[] = {
+    { "ubyte",  AL_FORMAT_MONO8,           CONV_SAMPLES   },
+    { "short",  AL_FORMAT_MONO16,          CONV_SAMPLES*2 },
+    { "float",  AL_FORMAT_MONO_FLOAT32,    CONV_SAMPLES*4 },
+    { "double", AL_FORMAT_MONO_DOUBLE_EXT, CONV_SAMPLES*8 },
+    { "mulaw",  AL_FORMAT_MONO_MULAW,      CONV_SAMPLES   },
+    /* 65 samples in each 36-byte block */
+    { "ima4",   AL_FORMAT_MONO_IMA4,       CONV_SAMPLES/65*36 },
+    { NULL, 0, 0 }
+};
+
+static void fillConvData(ALvoid *data, ALenum format, ALsizei size)
+{
+    ALsizei i;
+
+    switch(format)
+    {
+        case AL_FORMAT_MONO16:
+            for(i = 0;i < size/2;i++)
+                ((ALshort*)data)[i] = (ALshort)(noise()*16384.0f);
+            break;
+        case AL_FORMAT_MONO_FLOAT32:
+            for(i = 0;i < size/4;i++)
+                ((ALfloat*)data)[i] = noise()*0.5f;
+            break;
+        case AL_FORMAT_MONO_DOUBLE_EXT:
+            for(i = 0;i < size/8;i++)
+                ((ALdouble*)data)[i] = noise()*0.5f;
+            break;
+        default:
+            /* 8-bit, mulaw and IMA4 take any byte values */
+            for(i = 0;i < size;i++)
+                ((ALubyte*)data)[i] = (ALubyte)(noise()*128.0f + 128.0f);
+            break;
+    }
+}
+
+static void benchConversion(void)
+{
+    static const char *storageNames[] = { "ubyte", "short", "float" };
+    ALvoid *data;
+    ALuint buffer;
+    int i, run;
+
+    printf("Buffer conversion (ns/sample):\n");
+
+    data = malloc(CONV_SAMPLES*8);
+    alGenBuffers(1, &buffer);
+    for(i = 0;convFormats[i].name;i++)
+    {
+        ALsizei samples;
+        double best = 0.0;
+        ALint bits = 0;
+        clock_t start;
+
+        fillConvData(data, convFormats[i].format, convFormats[i].size);
+        samples = ((convFormats[i].format == AL_FORMAT_MONO_IMA4) ?
+                   convFormats[i].size/36*65 : CONV_SAMPLES);
+
+        for(run = 0;run < NUM_RUNS;run++)
+        {
+            double t;
+
+            start = clock();
+            alBufferData(buffer, convFormats[i].format, data,
+                         convFormats[i].size, FREQUENCY);
+            t = getSeconds(start);
+            if(run == 0 || t < best)
+                best = t;
+        }
+        alGetBufferi(buffer, AL_BITS, &bits);
+        if(alGetError() != AL_NO_ERROR)
+        {
+            printf("    %-6s -> !!! failed to load !!!\n", convFormats[i].name);
+            continue;
+        }
+
+        printf("    %-6s -> %-6s  %6.2f\n", convFormats[i].name,
+               storageNames[(bits==8) ? 0 : (bits==16) ? 1 : 2],
+               best*1e9 / samples);
+    }
+    alDeleteBuffers(1, &buffer);
+    free(data);
+}
+
+
+/* Renders the given number of samples, returning the best time of several
+ * runs. */
+static double timeRender(ALCdevice *device, ALsizei samples)
+{
+    static ALfloat output[RENDER_SIZE*2];
+    double best = 0.0;
+    clock_t start;
+    ALsizei done;
+    int run;
+
+    for(run = 0;run < NUM_RUNS;run++)
+    {
+        double t;
+
+        start = clock();
+        for(done = 0;done < samples;done += RENDER_SIZE)
+            palcRenderSamplesSOFT(device, output, RENDER_SIZE);
+        t = getSeconds(start);
+        if(run == 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+/* Creates a looping source playing a second of noise */
+static ALuint createNoiseSource(ALuint *buffer)
+{
+    ALfloat *data;
+    ALuint source;
+    ALsizei i;
+
+    data = malloc(FREQUENCY*sizeof(ALfloat));
+    for(i = 0;i < FREQUENCY;i++)
+        data[i] = noise()*0.5f;
+
+    alGenBuffers(1, buffer);
+    alBufferData(*buffer, AL_FORMAT_MONO_FLOAT32, data,
+                 FREQUENCY*sizeof(ALfloat), FREQUENCY);
+    free(data);
+
+    alGenSources(1, &source);
+    alSourcei(source, AL_BUFFER, *buffer);
+    alSourcei(source, AL_LOOPING, AL_TRUE);
+    return source;
+}
+
+
+/* Mixing cost and memory use of many voices playing long buffers, loaded as
+ * 16-bit and as float. With buffer-storage=short (or auto), the float data is
+ * stored as 16-bit too. */
+#define STORAGE_VOICES  32
+#define STORAGE_LENGTH  (FREQUENCY*4)
+#define STORAGE_SAMPLES (FREQUENCY*5)
+
+static void benchStorage(void)
+{
+    static const struct {
+        const char *name;
+        ALenum format;
+        ALsizei size;
+    } formats[] = {
+        { "short", AL_FORMAT_MONO16,       STORAGE_LENGTH*2 },
+        { "float", AL_FORMAT_MONO_FLOAT32, STORAGE_LENGTH*4 },
+        { NULL, 0, 0 }
+    };
+    ALCdevice *device = alcGetContextsDevice(alcGetCurrentContext());
+    ALuint sources[STORAGE_VOICES];
+    ALuint buffers[STORAGE_VOICES];
+    ALvoid *data;
+    int i, j;
+
+    printf("Buffer storage (%d voices, %ds each, ns/sample per voice):\n",
+           STORAGE_VOICES, STORAGE_LENGTH/FREQUENCY);
+
+    data = malloc(STORAGE_LENGTH*4);
+    alGenSources(STORAGE_VOICES, sources);
+    alGenBuffers(STORAGE_VOICES, buffers);
+    for(i = 0;formats[i].name;i++)
+    {
+        ALint size, bits = 0, total = 0;
+        double t;
+
+        for(j = 0;j < STORAGE_VOICES;j++)
+        {
+            // Different data for each, so buffer dedup can't merge them
+            fillConvData(data, formats[i].format, formats[i].size);
+            alBufferData(buffers[j], formats[i].format, data, formats[i].size,
+                         FREQUENCY);
+            alGetBufferi(buffers[j], AL_SIZE, &size);
+            alGetBufferi(buffers[j], AL_BITS, &bits);
+            total += size;
+
+            alSourcei(sources[j], AL_BUFFER, buffers[j]);
+            alSourcei(sources[j], AL_LOOPING, AL_TRUE);
+        }
+        alSourcePlayv(STORAGE_VOICES, sources);
+        if(alGetError() != AL_NO_ERROR)
+        {
+            printf("    %-5s  !!! failed to play !!!\n", formats[i].name);
+            break;
+        }
+
+        t = timeRender(device, STORAGE_SAMPLES);
+        printf("    %-5s  stored as %2d-bit, %5.1fMB  %6.2f\n", formats[i].name,
+               bits, total/1048576.0,
+               t*1e9 / STORAGE_SAMPLES / STORAGE_VOICES);
+
+        alSourceStopv(STORAGE_VOICES, sources);
+        for(j = 0;j < STORAGE_VOICES;j++)
+            alSourcei(sources[j], AL_BUFFER, 0);
+    }
+    alDeleteSources(STORAGE_VOICES, sources);
+    alDeleteBuffers(STORAGE_VOICES, buffers);
+    free(data);
+}
+
+
+/* Cost of each effect's processing, from one source sending to a slot. The
+ * time with a null effect in the slot is taken off. The mixer skips sends to
+ * null effects, so what's left is the effect's own work and its send. The
+ * cases are timed in turn over several rounds, so a change in load on the
+ * machine affects them all alike, and each timing uses a new slot so none
+ * inherits state from the one before. */
+#define EFFECT_SAMPLES (FREQUENCY*2)
+#define EFFECT_ROUNDS  10
+#define MAX_EFFECT_CASES 32
+
+/* Each case can set one integer and one float parameter, besides the type */
+static const struct {
+    const char *name;
+    ALenum type;
+    ALenum iparam;
+    ALint ivalue;
+    ALenum fparam;
+    ALfloat fvalue;
+} effectCases[] = {
+    { "reverb",          AL_EFFECT_REVERB,         0, 0, 0, 0.0f },
+    { "eaxreverb",       AL_EFFECT_EAXREVERB,      0, 0, 0, 0.0f },
+    { "echo",            AL_EFFECT_ECHO,           0, 0, 0, 0.0f },
+    /* Short first taps limit how many samples the echo does at once */
+    { "echo 1ms",        AL_EFFECT_ECHO,           0, 0,
+      AL_ECHO_DELAY, 0.001f },
+    { "echo no delay",   AL_EFFECT_ECHO,           0, 0,
+      AL_ECHO_DELAY, 0.0f },
+    { "chorus",          AL_EFFECT_CHORUS,         0, 0, 0, 0.0f },
+    { "chorus sine",     AL_EFFECT_CHORUS,
+      AL_CHORUS_WAVEFORM, AL_CHORUS_WAVEFORM_SINUSOID, 0, 0.0f },
+    { "flanger",         AL_EFFECT_FLANGER,        0, 0, 0, 0.0f },
+    { "flanger sine",    AL_EFFECT_FLANGER,
+      AL_FLANGER_WAVEFORM, AL_FLANGER_WAVEFORM_SINUSOID, 0, 0.0f },
+    { "ring mod sine",   AL_EFFECT_RING_MODULATOR,
+      AL_RING_MODULATOR_WAVEFORM, AL_RING_MODULATOR_SINUSOID, 0, 0.0f },
+    { "ring mod saw",    AL_EFFECT_RING_MODULATOR,
+      AL_RING_MODULATOR_WAVEFORM, AL_RING_MODULATOR_SAWTOOTH, 0, 0.0f },
+    { "ring mod square", AL_EFFECT_RING_MODULATOR,
+      AL_RING_MODULATOR_WAVEFORM, AL_RING_MODULATOR_SQUARE, 0, 0.0f },
+    { "equalizer",       AL_EFFECT_EQUALIZER,      0, 0, 0, 0.0f },
+    { "compressor",      AL_EFFECT_COMPRESSOR,     0, 0, 0, 0.0f },
+    { NULL, 0, 0, 0, 0, 0.0f }
+};
+
+/* Sends the source to a new slot with the effect, returning the render
+ * time or a negative value if the effect isn't supported */
+static double timeEffect(ALCdevice *device, ALuint source, ALuint effect, ALenum type, ALenum iparam, ALint ivalue, ALenum fparam, ALfloat fvalue)
+{
+    double t = -1.0;
+    ALuint slot;
+
+    alGetError();
+    palEffecti(effect, AL_EFFECT_TYPE, type);
+    if(iparam)
+        palEffecti(effect, iparam, ivalue);
+    if(fparam)
+        palEffectf(effect, fparam, fvalue);
+    if(alGetError() != AL_NO_ERROR)
+        return -1.0;
+
+    palGenAuxiliaryEffectSlots(1, &slot);
+    palAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, effect);
+    alSource3i(source, AL_AUXILIARY_SEND_FILTER, slot, 0, AL_FILTER_NULL);
+    if(alGetError() == AL_NO_ERROR)
+    {
+        // Let it settle before timing
+        timeRender(device, FREQUENCY/10);
+        t = timeRender(device, EFFECT_SAMPLES);
+    }
+    alSource3i(source, AL_AUXILIARY_SEND_FILTER, AL_EFFECTSLOT_NULL, 0,
+               AL_FILTER_NULL);
+    palDeleteAuxiliaryEffectSlots(1, &slot);
+    return t;
+}
+
+static void benchEffects(void)
+{
+    ALCdevice *device = alcGetContextsDevice(alcGetCurrentContext());
+    double best[MAX_EFFECT_CASES+1];
+    ALuint source, buffer, effect;
+    double base, t;
+    int i, round;
+
+    palGenEffects = alGetProcAddress("alGenEffects");
+    palDeleteEffects = alGetProcAddress("alDeleteEffects");
+    palEffecti = alGetProcAddress("alEffecti");
+    palEffectf = alGetProcAddress("alEffectf");
+    palGenAuxiliaryEffectSlots = alGetProcAddress("alGenAuxiliaryEffectSlots");
+    palDeleteAuxiliaryEffectSlots = alGetProcAddress("alDeleteAuxiliaryEffectSlots");
+    palAuxiliaryEffectSloti = alGetProcAddress("alAuxiliaryEffectSloti");
+    if(alcIsExtensionPresent(device, "ALC_EXT_EFX") == AL_FALSE ||
+       !palGenEffects || !palDeleteEffects || !palEffecti || !palEffectf ||
+       !palGenAuxiliaryEffectSlots || !palDeleteAuxiliaryEffectSlots ||
+       !palAuxiliaryEffectSloti)
+    {
+        printf("!!! EFX not available !!!\n");
+        return;
+    }
+
+    source = createNoiseSource(&buffer);
+    palGenEffects(1, &effect);
+    alSourcePlay(source);
+
+    // The last entry is the null effect
+    for(round = 0;round < EFFECT_ROUNDS;round++)
+    {
+        for(i = 0;i <= MAX_EFFECT_CASES;i++)
+        {
+            if(i == MAX_EFFECT_CASES)
+                t = timeEffect(device, source, effect, AL_EFFECT_NULL,
+                               0, 0, 0, 0.0f);
+            else if(effectCases[i].name)
+                t = timeEffect(device, source, effect, effectCases[i].type,
+                               effectCases[i].iparam, effectCases[i].ivalue,
+                               effectCases[i].fparam, effectCases[i].fvalue);
+            else
+                continue;
+            if(round == 0 || t < best[i])
+                best[i] = t;
+        }
+    }
+
+    base = best[MAX_EFFECT_CASES];
+    printf("Effects (ns/sample per slot, including the send; the source alone takes %.2f):\n",
+           base*1e9 / EFFECT_SAMPLES);
+    for(i = 0;effectCases[i].name;i++)
+    {
+        if(best[i] < 0.0)
+            printf("    %-20s  not supported\n", effectCases[i].name);
+        else
+            printf("    %-20s  %6.2f\n", effectCases[i].name,
+                   (best[i]-base)*1e9 / EFFECT_SAMPLES);
+    }
+
+    alSourceStop(source);
+    alDeleteSources(1, &source);
+    alDeleteBuffers(1, &buffer);
+    palDeleteEffects(1, &effect);
+}
+
+
+static const struct {
+    const char *name;
+    void (*func)(void);
+} benchmarks[] = {
+    { "conversion", benchConversion },
+    { "storage",    benchStorage    },
+    { "effects",    benchEffects    },
+    { NULL, NULL }
+};
+
+int main(int argc, char *argv[])
+{
+    ALCint attrs[] = {
+        ALC_FREQUENCY, FREQUENCY,
+        ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+        ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+        0
+    };
+    ALCdevice *device;
+    ALCcontext *context;
+    int i, j, ran = 0;
+
+    if(argc > 1 && (strcmp(argv[1], "--help") == 0 ||
+                    strcmp(argv[1], "-h") == 0))
+    {
+        printf("Usage: %s [benchmark...]\n\nBenchmarks:\n", argv[0]);
+        for(i = 0;benchmarks[i].name;i++)
+            printf("    %s\n", benchmarks[i].name);
+        printf("\nRuns all of them if none are given.\n");
+        return 0;
+    }
+
+    if(alcIsExtensionPresent(NULL, "ALC_SOFT_loopback") == AL_FALSE)
+    {
+        printf("!!! ALC_SOFT_loopback not available !!!\n");
+        return 1;
+    }
+    palcLoopbackOpenDeviceSOFT = alcGetProcAddress(NULL, "alcLoopbackOpenDeviceSOFT");
+    palcRenderSamplesSOFT = alcGetProcAddress(NULL, "alcRenderSamplesSOFT");
+
+    device = palcLoopbackOpenDeviceSOFT(NULL);
+    if(!device)
+    {
+        printf("!!! Failed to open a loopback device !!!\n");
+        return 1;
+    }
+    context = alcCreateContext(device, attrs);
+    if(!context || alcMakeContextCurrent(context) == ALC_FALSE)
+    {
+        if(context)
+            alcDestroyContext(context);
+        alcCloseDevice(device);
+        printf("!!! Failed to set a context !!!\n");
+        return 1;
+    }
+
+    for(i = 0;benchmarks[i].name;i++)
+    {
+        if(argc > 1)
+        {
+            for(j = 1;j < argc;j++)
+            {
+                if(strcmp(argv[j], benchmarks[i].name) == 0)
+                    break;
+            }
+            if(j == argc)
+                continue;
+        }
+        if(ran++ > 0)
+            printf("\n");
+        benchmarks[i].func();
+    }
+    if(ran == 0)
+        printf("!!! No benchmark named %s !!!\n", argv[1]);
+
+    alcMakeContextCurrent(NULL);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+
+    return (ran == 0);
+}